@@ -0,0 +1,1748 @@
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+#include <random>
+#include <sstream>
+#include <new>
+#include <cstdlib>
+#include "benchmark.h"
+#include "values_extract.h"
+#include "values_file_extract.h"
+
+using namespace values;
+
+// Every allocation is counted for the allocs/item column. All the forms of
+// operator new and delete are replaced, so that each delete frees what the
+// matching new allocated.
+static void* CountedAlloc(size_t size, size_t alignment)
+{
+	BenchmarkAllocations::Count();
+	if (size == 0)
+		size = 1;
+#if defined(_MSC_VER)
+	void* p = _aligned_malloc(size, alignment);
+#else
+	void* p = nullptr;
+	if (posix_memalign(&p, alignment < sizeof(void*) ? sizeof(void*) : alignment, size) != 0)
+		p = nullptr;
+#endif
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return p;
+}
+
+static void CountedFree(void* p) noexcept
+{
+#if defined(_MSC_VER)
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+void* operator new(size_t size)
+{
+	return CountedAlloc(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](size_t size)
+{
+	return CountedAlloc(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return CountedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return CountedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+	CountedFree(p);
+}
+
+// The four-scan tokenizer of version 0.1.1, kept as the baseline to compare
+// TokenizeFmtString against.
+namespace legacy
+{
+	namespace detail
+	{
+		inline std::vector<Token> Find(const std::string& input, const char* find, TokenType type)
+		{
+			std::vector<Token> vec;
+			size_t find_size = strlen(find);
+			if (find_size == 0)
+				return {};
+
+			size_t pos = 0;
+			pos = input.find(find);
+			while (pos != std::string::npos)
+			{
+				// the other fields are value-initialized
+				Token token = Token();
+				token.index = -1;
+				token.start = pos;
+				token.size = find_size;
+				token.type = type;
+				vec.push_back(token);
+				pos += find_size;
+				pos = input.find(find, pos);
+			}
+			return vec;
+		}
+	}
+
+	inline std::vector<Token> LegacyTokenizeFmtString(const std::string& fmt)
+	{
+		std::vector<Token> vecMatter = detail::Find(fmt, "{}", TokenType::Matter);
+		std::vector<Token> vecHex = detail::Find(fmt, "{h}", TokenType::Hex);
+		std::vector<Token> vecX = detail::Find(fmt, "{x}", TokenType::None);
+		std::vector<Token> vecTrim = detail::Find(fmt, "{t}", TokenType::Trim);
+
+		std::vector<Token> vec;
+		for (auto& a : vecMatter)
+		{
+			vec.push_back(a);
+		}
+		for (auto& a : vecHex)
+		{
+			vec.push_back(a);
+		}
+		for (auto& a : vecX)
+		{
+			vec.push_back(a);
+		}
+		for (auto& a : vecTrim)
+		{
+			vec.push_back(a);
+		}
+
+		int countDiffTokenType = 0;
+		if (vecMatter.size() > 0)
+			countDiffTokenType++;
+		if (vecHex.size() > 0)
+			countDiffTokenType++;
+		if (vecX.size() > 0)
+			countDiffTokenType++;
+		if (vecTrim.size() > 0)
+			countDiffTokenType++;
+
+		if (countDiffTokenType > 1)
+		{
+			if (std::is_sorted(vec.begin(), vec.end(), [](const Token& a, const Token& b)
+				{ return a.start < b.start; }) == false)
+			{
+				std::sort(vec.begin(), vec.end(), [](const Token& a, const Token& b)
+					{ return a.start < b.start; });
+			}
+		}
+
+		for (size_t i = 0; i < vec.size(); ++i)
+		{
+			auto& curr = vec[i];
+
+			if (i == 0)
+			{
+				if (curr.start == 0)
+				{
+					curr.prefix = "";
+				}
+				else
+				{
+					curr.prefix = fmt.substr(0, curr.start);
+				}
+
+				if (i + 1 < vec.size())
+				{
+					auto& next = vec[i + 1];
+					if (curr.start + curr.size == next.start)
+					{
+						std::cerr << "Error: Format specifier {} cannot be side by side! For example: {}{}\n";
+						return {};
+					}
+					else if (curr.start + curr.size < next.start)
+					{
+						curr.postfix = fmt.substr(curr.start + curr.size, next.start - (curr.start + curr.size));
+					}
+				}
+				else
+				{
+					curr.postfix = fmt.substr(curr.start + curr.size);
+				}
+				continue;
+			}
+
+			if (i + 1 < vec.size() && i > 0)
+			{
+				auto& prev = vec[i - 1];
+
+				curr.prefix = fmt.substr(prev.start + prev.size, curr.start - (prev.start + prev.size));
+
+				auto& next = vec[i + 1];
+				if (curr.start + curr.size == next.start)
+				{
+					std::cerr << "Error: Format specifier {} cannot be side by side! For example: {}{}\n";
+					return {};
+				}
+				else if (curr.start + curr.size < next.start)
+				{
+					curr.postfix = fmt.substr(curr.start + curr.size, next.start - (curr.start + curr.size));
+				}
+				continue;
+			}
+
+			if (i == (vec.size() - 1) && i > 0)
+			{
+				auto& prev = vec[i - 1];
+
+				curr.prefix = fmt.substr(prev.start + prev.size, curr.start - (prev.start + prev.size));
+				curr.postfix = fmt.substr(curr.start + curr.size);
+			}
+		}
+
+		int index = 0;
+		for (auto& a : vec)
+		{
+			if (a.type != TokenType::None)
+			{
+				a.index = index;
+
+				++index;
+			}
+		}
+
+		return vec;
+	}
+
+	// The search of version 0.1.2: memchr on the first byte, then memcmp
+	inline size_t LegacySearch(StringView input, StringView find, size_t pos)
+	{
+		if (pos > input.size || input.size - pos < find.size)
+			return StringView::npos;
+		if (find.empty())
+			return pos;
+
+		const char* curr = input.data + pos;
+		const char* last = input.data + input.size - find.size + 1;
+		while (curr < last)
+		{
+			curr = static_cast<const char*>(memchr(curr, find[0], last - curr));
+			if (curr == nullptr)
+				return StringView::npos;
+			if (memcmp(curr + 1, find.data + 1, find.size - 1) == 0)
+				return curr - input.data;
+			++curr;
+		}
+		return StringView::npos;
+	}
+}
+
+// Generates formats shaped like the log statements of a service: a few
+// words, then a mix of specifiers separated by "Key:" literals.
+std::vector<std::string> GenerateFormats(size_t count)
+{
+	static const char* words[] = { "REGISTER", "LOGIN", "LOGOUT", "PAYMENT", "ORDER", "SHIPPED",
+		"Connection", "refused", "accepted", "from", "user", "session", "timeout", "retry" };
+	static const char* keys[] = { "Name", "Age", "ID", "CustomerID", "Amount", "Currency", "Host",
+		"Port", "Status", "Latency", "Bytes", "Path", "Method", "Agent" };
+	static const char* specs[] = { "{}", "{h}", "{x}", "{t}" };
+
+	std::mt19937 rng(12345);
+	std::vector<std::string> formats;
+	formats.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::string fmt;
+		size_t numWords = 1 + rng() % 3;
+		for (size_t w = 0; w < numWords; ++w)
+		{
+			fmt += words[rng() % (sizeof(words) / sizeof(words[0]))];
+			fmt += ' ';
+		}
+		fmt += std::to_string(i);
+		size_t numFields = 1 + rng() % 6;
+		for (size_t f = 0; f < numFields; ++f)
+		{
+			fmt += (f == 0) ? " " : ", ";
+			fmt += keys[rng() % (sizeof(keys) / sizeof(keys[0]))];
+			fmt += ':';
+			fmt += specs[rng() % (sizeof(specs) / sizeof(specs[0]))];
+		}
+		formats.push_back(fmt);
+	}
+	return formats;
+}
+
+static const size_t FormatCount = 5000;
+
+void TokenizeLegacy(BenchmarkState& state)
+{
+	static const std::vector<std::string> formats = GenerateFormats(FormatCount);
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		for (const auto& fmt : formats)
+		{
+			std::vector<Token> tokens = legacy::LegacyTokenizeFmtString(fmt);
+			Benchmark::DoNotOptimize(tokens);
+		}
+		items += formats.size();
+	}
+	state.SetItemsProcessed(items);
+}
+
+void TokenizeSinglePass(BenchmarkState& state)
+{
+	static const std::vector<std::string> formats = GenerateFormats(FormatCount);
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		for (const auto& fmt : formats)
+		{
+			std::vector<Token> tokens = TokenizeFmtString(fmt);
+			Benchmark::DoNotOptimize(tokens);
+		}
+		items += formats.size();
+	}
+	state.SetItemsProcessed(items);
+}
+
+static const char* RegisterFmt = "REGISTER Name:{}, Age:{}";
+
+static const std::string RegisterInput = "2025-01-01 12:00:00.001 REGISTER Name:Sherry, Age:20";
+
+void ExtractPerCallFmt(BenchmarkState& state)
+{
+	std::string name;
+	int age = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ValuesExtract(RegisterInput, RegisterFmt, name, age);
+		Benchmark::DoNotOptimize(age);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+// The fmt looked up in the global cache instead of tokenized
+void ExtractPerCallFmtCached(BenchmarkState& state)
+{
+	EnableFormatCache();
+	std::string name;
+	int age = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ValuesExtract(RegisterInput, RegisterFmt, name, age);
+		Benchmark::DoNotOptimize(age);
+		++items;
+	}
+	EnableFormatCache(false);
+	state.SetItemsProcessed(items);
+}
+
+void ExtractPreTokenized(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(RegisterFmt);
+	std::string name;
+	int age = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ValuesExtract(RegisterInput, tokens, name, age);
+		Benchmark::DoNotOptimize(age);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+void ExtractChecked(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(RegisterFmt);
+	std::string name;
+	int age = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = ValuesExtractChecked(RegisterInput, tokens, name, age);
+		Benchmark::DoNotOptimize(result);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+// Malformed lines are counted without going through std::cerr
+void ExtractCheckedMismatch(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(RegisterFmt);
+	const std::string input = "2025-01-01 12:00:00.001 REGISTER Name:Sherry, Age:twenty";
+	std::string name;
+	int age = 0;
+	size_t items = 0;
+	size_t failed = 0;
+	while (state.KeepRunning())
+	{
+		if (!ValuesExtractChecked(input, tokens, name, age))
+			++failed;
+		++items;
+	}
+	Benchmark::DoNotOptimize(failed);
+	state.SetItemsProcessed(items);
+}
+
+// Same as ExtractChecked: the literal shared by two fields is searched for
+// once
+void ExtractCompiled(BenchmarkState& state)
+{
+	CompiledFormat format(RegisterFmt);
+	std::string name;
+	int age = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = format.Extract(RegisterInput, name, age);
+		Benchmark::DoNotOptimize(result);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+void ExtractDataTypeRef(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(RegisterFmt);
+	std::string name;
+	int age = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		std::vector<DataTypeRef> results;
+		detail::AddData(results, name, age);
+		detail::ValuesExtractHelp(RegisterInput, tokens, results);
+		Benchmark::DoNotOptimize(age);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+#ifdef VALUES_HAS_CONSTEXPR14
+void ExtractCompileTime(BenchmarkState& state)
+{
+	std::string name;
+	int age = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ValuesExtract(RegisterInput, VALUES_FMT("REGISTER Name:{}, Age:{}"), name, age);
+		Benchmark::DoNotOptimize(age);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+#endif
+
+// Numeric fields as they appear in log lines
+std::vector<std::string> GenerateNumbers(size_t count, int kind)
+{
+	std::mt19937_64 rng(4242);
+	std::vector<std::string> numbers;
+	numbers.reserve(count);
+	char buf[64];
+	for (size_t i = 0; i < count; ++i)
+	{
+		uint64_t r = rng();
+		switch (kind)
+		{
+		case 0: // short decimal, e.g. ages and ports
+			snprintf(buf, sizeof(buf), "%u", (unsigned)(r % 100000));
+			break;
+		case 1: // 8 to 16 digit ids
+			snprintf(buf, sizeof(buf), "%llu", (unsigned long long)(r % 10000000000000000ULL));
+			break;
+		case 2: // hexadecimal with 0x
+			snprintf(buf, sizeof(buf), "0x%llX", (unsigned long long)(r >> (r % 48)));
+			break;
+		default: // decimal with fraction, e.g. latencies and amounts
+			snprintf(buf, sizeof(buf), "%u.%03u", (unsigned)(r % 100000), (unsigned)((r >> 32) % 1000));
+			break;
+		}
+		numbers.push_back(buf);
+	}
+	return numbers;
+}
+
+template<typename T>
+T LegacyConvert(const std::string& field, TokenType type);
+
+template<> int32_t LegacyConvert<int32_t>(const std::string& field, TokenType type)
+{
+	std::string copy = field.substr(0);
+	return strtol(copy.c_str(), nullptr, type == TokenType::Hex ? 16 : 10);
+}
+
+template<> int64_t LegacyConvert<int64_t>(const std::string& field, TokenType type)
+{
+	std::string copy = field.substr(0);
+	return strtoll(copy.c_str(), nullptr, type == TokenType::Hex ? 16 : 10);
+}
+
+template<> uint64_t LegacyConvert<uint64_t>(const std::string& field, TokenType type)
+{
+	std::string copy = field.substr(0);
+	return strtoull(copy.c_str(), nullptr, type == TokenType::Hex ? 16 : 10);
+}
+
+template<> float LegacyConvert<float>(const std::string& field, TokenType)
+{
+	std::string copy = field.substr(0);
+	return strtof(copy.c_str(), nullptr);
+}
+
+template<> double LegacyConvert<double>(const std::string& field, TokenType)
+{
+	std::string copy = field.substr(0);
+	return strtod(copy.c_str(), nullptr);
+}
+
+// substr copy + strtol family, as ConvStrToType did in 0.1.1
+template<typename T, int Kind, TokenType Type>
+void ConvertLegacy(BenchmarkState& state)
+{
+	static const std::vector<std::string> numbers = GenerateNumbers(1000, Kind);
+	size_t items = 0;
+	size_t bytes = 0;
+	while (state.KeepRunning())
+	{
+		for (const auto& number : numbers)
+		{
+			T value = LegacyConvert<T>(number, Type);
+			Benchmark::DoNotOptimize(value);
+			bytes += number.size();
+		}
+		items += numbers.size();
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(bytes);
+}
+
+template<typename T, int Kind, TokenType Type>
+void ConvertKernel(BenchmarkState& state)
+{
+	static const std::vector<std::string> numbers = GenerateNumbers(1000, Kind);
+	size_t items = 0;
+	size_t bytes = 0;
+	while (state.KeepRunning())
+	{
+		for (const auto& number : numbers)
+		{
+			T value = 0;
+			detail::ConvertTo(number, Type, value);
+			Benchmark::DoNotOptimize(value);
+			bytes += number.size();
+		}
+		items += numbers.size();
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(bytes);
+}
+
+// Log lines of the formats in the catalog, with a timestamp in front
+std::vector<std::string> GenerateLines(const std::vector<std::string>& formats, size_t count)
+{
+	std::mt19937 rng(54321);
+	std::vector<std::string> lines;
+	lines.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::string line = "2025-01-01 12:00:00.001 ";
+		const std::string& fmt = formats[rng() % formats.size()];
+		for (size_t pos = 0; pos < fmt.size(); ++pos)
+		{
+			if (fmt.compare(pos, 3, "{h}") == 0)
+				line += "30AB";
+			else if (fmt.compare(pos, 3, "{x}") == 0)
+				line += "skipped";
+			else if (fmt.compare(pos, 3, "{t}") == 0)
+				line += " trimmed ";
+			else if (fmt.compare(pos, 2, "{}") == 0)
+				line += "Sherry";
+			else
+			{
+				line += fmt[pos];
+				continue;
+			}
+			pos = fmt.find('}', pos);
+		}
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+struct Catalog
+{
+	explicit Catalog(size_t count)
+	{
+		std::vector<std::string> formats = GenerateFormats(count);
+		for (const auto& fmt : formats)
+		{
+			tokens.push_back(TokenizeFmtString(fmt));
+			set.Add(tokens.back());
+		}
+		set.Build();
+		lines = GenerateLines(formats, 1000);
+	}
+
+	std::vector<std::vector<Token> > tokens;
+	FormatSet set;
+	std::vector<std::string> lines;
+};
+
+// Classifying a line by trying every format of the catalog in turn
+template<size_t Count>
+void ClassifyLoop(BenchmarkState& state)
+{
+	static const Catalog catalog(Count);
+	size_t items = 0;
+	size_t bytes = 0;
+	while (state.KeepRunning())
+	{
+		const std::string& line = catalog.lines[items % catalog.lines.size()];
+		size_t found = FormatSet::npos;
+		for (size_t id = 0; id < catalog.tokens.size(); ++id)
+		{
+			if (IsInputMatchedTokens(line, catalog.tokens[id]))
+			{
+				found = id;
+				break;
+			}
+		}
+		Benchmark::DoNotOptimize(found);
+		++items;
+		bytes += line.size();
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(bytes);
+}
+
+template<size_t Count>
+void ClassifyFormatSet(BenchmarkState& state)
+{
+	static const Catalog catalog(Count);
+	FormatMatch match;
+	// grows the buffers of the candidates and of the fields beforehand
+	for (const std::string& line : catalog.lines)
+		catalog.set.Match(line, match);
+
+	size_t items = 0;
+	size_t bytes = 0;
+	while (state.KeepRunning())
+	{
+		const std::string& line = catalog.lines[items % catalog.lines.size()];
+		catalog.set.Match(line, match);
+		Benchmark::DoNotOptimize(match.id);
+		++items;
+		bytes += line.size();
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(bytes);
+
+	// a line is classified without allocating
+	if (BenchmarkAllocations::IsEnabled() && state.Allocations() != 0)
+		std::cerr << "Classify.FormatSet/" << Count << ": " << state.Allocations() << " allocations in " << items << " lines\n";
+}
+
+// Delimiters of 1 to 16 bytes, searched for at the end of log lines
+static const char* Delimiters[] = { "#", "Age:", ", Agent:", " ResponseBytes:" };
+
+// A log line of about length bytes made of "Key:value" pairs, which ends
+// with the delimiter and does not contain it before
+std::string GenerateSearchLine(size_t length, const char* delimiter)
+{
+	static const char* keys[] = { "Name", "User", "ID", "CustomerID", "Amount", "Currency", "Host",
+		"Port", "Status", "Latency", "Bytes", "Path", "Method", "Session" };
+	static const char* values[] = { "Sherry", "30AB", "200", "GET", "/api/v1/orders", "12.5ms",
+		"accepted", "eu-west-1", "Mozilla/5.0", "true" };
+
+	std::mt19937 rng(777);
+	std::string line = "2025-01-01 12:00:00.001 INFO";
+	while (line.size() < length)
+	{
+		line += (line.size() < 40) ? " " : ", ";
+		line += keys[rng() % (sizeof(keys) / sizeof(keys[0]))];
+		line += ':';
+		line += values[rng() % (sizeof(values) / sizeof(values[0]))];
+	}
+	if (line.find(delimiter) != std::string::npos)
+		return std::string();
+	return line + delimiter + "20";
+}
+
+enum class SearchMethod { StdFind, Legacy, Searcher };
+
+template<size_t Length, size_t Delimiter, SearchMethod Method>
+void SearchDelimiter(BenchmarkState& state)
+{
+	const std::string line = GenerateSearchLine(Length, Delimiters[Delimiter]);
+	const std::string find = Delimiters[Delimiter];
+	const detail::Searcher searcher = detail::MakeSearcher(find);
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		size_t pos = 0;
+		if (Method == SearchMethod::StdFind)
+			pos = line.find(find);
+		else if (Method == SearchMethod::Legacy)
+			pos = legacy::LegacySearch(line, find, 0);
+		else
+			pos = detail::Search(line, find, searcher, 0);
+		Benchmark::DoNotOptimize(pos);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(items * line.size());
+}
+
+template<size_t Length, size_t Delimiter>
+void AddSearchBenchmarks()
+{
+	std::string name = "Len" + std::to_string(Length) + "/Delim" + std::to_string(strlen(Delimiters[Delimiter]));
+	Benchmark::Add("Search", name + ".StdFind", SearchDelimiter<Length, Delimiter, SearchMethod::StdFind>);
+	Benchmark::Add("Search", name + ".Legacy", SearchDelimiter<Length, Delimiter, SearchMethod::Legacy>);
+	Benchmark::Add("Search", name + ".Searcher", SearchDelimiter<Length, Delimiter, SearchMethod::Searcher>);
+}
+
+static const char* BatchFmt = "REGISTER Name:{}, Age:{}, Score:{}, ID:{h}";
+
+std::vector<std::string> GenerateBatchLines(size_t count)
+{
+	static const char* names[] = { "Sherry", "John", "Amy", "Bob", "Williams" };
+	std::mt19937 rng(99);
+	std::vector<std::string> lines;
+	for (size_t i = 0; i < count; ++i)
+	{
+		lines.push_back("2025-01-01 12:00:00.001 REGISTER Name:" + std::string(names[rng() % 5]) +
+			", Age:" + std::to_string(rng() % 100) + ", Score:" + std::to_string(rng() % 1000) + ".25" +
+			", ID:" + std::to_string(rng() % 100000));
+	}
+	return lines;
+}
+
+// One ValuesExtract per line into scalars, copied into the columns
+void BatchPerLine(BenchmarkState& state)
+{
+	static const std::vector<std::string> lines = GenerateBatchLines(1000);
+	std::vector<Token> tokens = TokenizeFmtString(BatchFmt);
+	std::vector<uint64_t> nameOffsets;
+	std::string nameBytes;
+	std::vector<int64_t> ages;
+	std::vector<double> scores;
+	std::vector<int64_t> ids;
+	std::vector<uint8_t> validity;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		nameOffsets.assign(1, 0);
+		nameBytes.clear();
+		ages.clear();
+		scores.clear();
+		ids.clear();
+		validity.assign((lines.size() + 7) / 8, 0);
+		for (size_t row = 0; row < lines.size(); ++row)
+		{
+			StringView name;
+			int64_t age = 0;
+			double score = 0;
+			int64_t id = 0;
+			if (ValuesExtractChecked(lines[row], tokens, name, age, score, id))
+				validity[row >> 3] |= static_cast<uint8_t>(1u << (row & 7));
+			nameBytes.append(name.data, name.size);
+			nameOffsets.push_back(static_cast<uint64_t>(nameBytes.size()));
+			ages.push_back(age);
+			scores.push_back(score);
+			ids.push_back(id);
+		}
+		Benchmark::DoNotOptimize(ids);
+		items += lines.size();
+	}
+	state.SetItemsProcessed(items);
+}
+
+void BatchColumns(BenchmarkState& state)
+{
+	static const std::vector<std::string> lines = GenerateBatchLines(1000);
+	std::vector<StringView> views(lines.begin(), lines.end());
+	BatchExtractor batch(BatchFmt, { ColumnType::String, ColumnType::Int64, ColumnType::Double, ColumnType::Int64 });
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		batch.Clear();
+		batch.Extract(views);
+		Benchmark::DoNotOptimize(batch.GetColumn(3).int64s);
+		items += lines.size();
+	}
+	state.SetItemsProcessed(items);
+}
+
+struct RegisterRow
+{
+	StringView name;
+	int age;
+};
+
+// About 32 MB of log, in memory so that the disk is not measured
+const std::string& EngineLog()
+{
+	static std::string log;
+	if (log.empty())
+	{
+		std::vector<std::string> lines = GenerateBatchLines(1000);
+		while (log.size() < 32 * 1024 * 1024)
+		{
+			for (const auto& line : lines)
+			{
+				log += line;
+				log += '\n';
+			}
+			log += "2025-01-01 12:00:00.001 LOGIN UserName:Sherry Williams, CustomerID:30AB\n";
+		}
+	}
+	return log;
+}
+
+template<size_t Threads, MergeOrder Order>
+void EngineRun(BenchmarkState& state)
+{
+	const std::string& log = EngineLog();
+	FileExtractor engine(TokenizeFmtString("REGISTER Name:{}, Age:{}"), Threads);
+	size_t lines = 0;
+	size_t bytes = 0;
+	while (state.KeepRunning())
+	{
+		std::vector<RegisterRow> rows;
+		FileExtractStats stats = engine.Run(log, [](StringView line, const std::vector<Token>& tokens, RegisterRow& row)
+		{
+			return (bool)ValuesExtractChecked(line, tokens, row.name, row.age);
+		}, rows, Order);
+		Benchmark::DoNotOptimize(rows);
+		lines += stats.lines;
+		bytes += stats.bytes;
+	}
+	state.SetItemsProcessed(lines);
+	state.SetBytesProcessed(bytes);
+}
+
+// The 32 MB log read from a stream in blocks of BlockSize bytes
+template<size_t BlockSize>
+void StreamRead(BenchmarkState& state)
+{
+	std::istringstream in(EngineLog());
+	StreamExtractor stream(TokenizeFmtString("REGISTER Name:{}, Age:{}"), BlockSize);
+	StringView name;
+	int age = 0;
+	size_t lines = 0;
+	size_t bytes = 0;
+	while (state.KeepRunning())
+	{
+		in.clear();
+		in.seekg(0);
+		long long sum = 0;
+		stream.Read(in, [&](StringView) { sum += age; }, name, age);
+		Benchmark::DoNotOptimize(sum);
+		lines += stream.Lines();
+		bytes += EngineLog().size();
+	}
+	state.SetItemsProcessed(lines);
+	state.SetBytesProcessed(bytes);
+}
+
+// Half of the lines match: matching first and then extracting scans the
+// matching lines twice
+static const std::string FusedInputs[] = {
+	"2025-01-01 12:00:00.001 REGISTER Name:Sherry, Age:20",
+	"2025-01-01 12:00:00.002 LOGIN UserName:Sherry Williams, CustomerID:30AB",
+};
+
+void FusedMatchThenExtract(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(RegisterFmt);
+	StringView name;
+	int age = 0;
+	size_t items = 0;
+	size_t matched = 0;
+	while (state.KeepRunning())
+	{
+		const std::string& input = FusedInputs[items & 1];
+		if (IsInputMatchedTokens(input, tokens))
+		{
+			ValuesExtract(input, tokens, name, age);
+			++matched;
+		}
+		++items;
+	}
+	Benchmark::DoNotOptimize(matched);
+	state.SetItemsProcessed(items);
+}
+
+void FusedTryExtract(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(RegisterFmt);
+	StringView name;
+	int age = 0;
+	size_t items = 0;
+	size_t matched = 0;
+	while (state.KeepRunning())
+	{
+		if (TryExtract(FusedInputs[items & 1], tokens, name, age))
+			++matched;
+		++items;
+	}
+	Benchmark::DoNotOptimize(matched);
+	state.SetItemsProcessed(items);
+}
+
+static const size_t LookupsPerThread = 100000;
+
+// Lookups of a few formats from many threads at once
+template<size_t Threads>
+void CacheLookup(BenchmarkState& state)
+{
+	const char* fmts[] = { RegisterFmt, "LOGIN UserName:{}, CustomerID:{h}", "LOGOUT UserName:{}" };
+	FormatCache cache;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < Threads; ++t)
+		{
+			threads.emplace_back([&cache, &fmts]()
+			{
+				size_t args = 0;
+				for (size_t i = 0; i < LookupsPerThread; ++i)
+					args += cache.Get(fmts[i % 3])->Args();
+				Benchmark::DoNotOptimize(args);
+			});
+		}
+		for (auto& thread : threads)
+			thread.join();
+		items += Threads * LookupsPerThread;
+	}
+	state.SetItemsProcessed(items);
+}
+
+// The timestamp is 24 characters long: with {@24} the first literal is
+// compared at that offset instead of searched for, on the lines which
+// match and on those which do not
+static const char* AnchorFmts[] = { "REGISTER Name:{}, Age:{}", "{@24}REGISTER Name:{}, Age:{}" };
+
+static const std::string AnchorInputs[] = {
+	RegisterInput,
+	"2025-01-01 12:00:00.001 LOGIN UserName:Sherry Williams, CustomerID:30AB, Agent:Mozilla/5.0 (X11; Linux x86_64)",
+};
+
+template<int Fmt, int Input>
+void AnchorMatch(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(AnchorFmts[Fmt]);
+	StringView name;
+	int age = 0;
+	size_t items = 0;
+	size_t matched = 0;
+	while (state.KeepRunning())
+	{
+		if (TryExtract(AnchorInputs[Input], tokens, name, age))
+			++matched;
+		++items;
+	}
+	Benchmark::DoNotOptimize(matched);
+	state.SetItemsProcessed(items);
+}
+
+// A machine-generated record with fixed-width columns, extracted by
+// searching for the postfixes or by slicing the fields
+static const char* WidthFmts[] = { "ID:{h}TS:{}SEQ:{}|{}", "ID:{8h}TS:{14}SEQ:{6}|{}" };
+
+static const std::string WidthInput = "ID:0000ABCDTS:20250131120000SEQ:000042|Sherry Williams";
+
+template<int Fmt>
+void WidthExtract(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(WidthFmts[Fmt]);
+	uint32_t id = 0;
+	uint64_t ts = 0;
+	int seq = 0;
+	StringView name;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = ValuesExtractChecked(WidthInput, tokens, id, ts, seq, name);
+		Benchmark::DoNotOptimize(result);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+// Fields separated by a single space, which is searched for or where the
+// class of the field ends
+static const char* ClassFmts[] = { "GET {} {} {} {} ", "GET {w} {d} {d} {d} " };
+
+static const std::string ClassInput = "GET /index.html 200 51234 17 Mozilla/5.0";
+
+template<int Fmt>
+void ClassExtract(BenchmarkState& state)
+{
+	std::vector<Token> tokens = TokenizeFmtString(ClassFmts[Fmt]);
+	StringView path;
+	int status = 0;
+	int bytes = 0;
+	int ms = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = ValuesExtractChecked(ClassInput, tokens, path, status, bytes, ms);
+		Benchmark::DoNotOptimize(result);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+// Inputs made to defeat the matcher: a long delimiter whose prefix fills
+// the line, and a line of repeated delimiters without the last one. The
+// MB/s should not drop as the line grows.
+static const std::string PathologicalFind = std::string(256, 'x') + ",";
+
+template<size_t Length, SearchMethod Method>
+void PathologicalSearch(BenchmarkState& state)
+{
+	const std::string line(Length, 'x');
+	const detail::Searcher searcher = detail::MakeSearcher(PathologicalFind);
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		size_t pos = 0;
+		if (Method == SearchMethod::StdFind)
+			pos = line.find(PathologicalFind);
+		else
+			pos = detail::Search(line, PathologicalFind, searcher, 0);
+		Benchmark::DoNotOptimize(pos);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(items * line.size());
+}
+
+template<size_t Repeats>
+void PathologicalExtract(BenchmarkState& state)
+{
+	std::string line = "A:";
+	for (size_t i = 0; i < Repeats; ++i)
+		line += ", B:, A:";
+	std::vector<Token> tokens = TokenizeFmtString("A:{}, B:{}, A:{}, C:{}");
+	StringView a, b, c, d;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = ValuesExtractChecked(line, tokens, a, b, c, d);
+		Benchmark::DoNotOptimize(result);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(items * line.size());
+}
+
+// A batch of rows whose string fields are too long for the small string
+// buffer: every std::string allocates, the arena reuses its blocks.
+static const char* ArenaFmt = "REGISTER Name:{}, Email:{}, Age:{}";
+
+std::vector<std::string> GenerateArenaLines(size_t count)
+{
+	static const char* names[] = { "Sherry Williams-Richardson", "John Alexander Smith", "Amy Catherine Brown" };
+	std::mt19937 rng(7);
+	std::vector<std::string> lines;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const std::string name = names[rng() % 3];
+		lines.push_back("2025-01-01 12:00:00.001 REGISTER Name:" + name + ", Email:user" +
+			std::to_string(rng() % 100000) + "@example.com, Age:" + std::to_string(rng() % 100));
+	}
+	return lines;
+}
+
+template<typename String>
+struct ArenaRow
+{
+	String name;
+	String email;
+	int age;
+};
+
+void ArenaStdString(BenchmarkState& state)
+{
+	static const std::vector<std::string> lines = GenerateArenaLines(1000);
+	CompiledFormat format(ArenaFmt);
+	std::vector<ArenaRow<std::string>> rows;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		rows.clear();
+		for (const auto& line : lines)
+		{
+			ArenaRow<std::string> row;
+			row.age = 0;
+			if (format.Extract(line, row.name, row.email, row.age))
+				rows.push_back(std::move(row));
+		}
+		Benchmark::DoNotOptimize(rows);
+		items += lines.size();
+	}
+	state.SetItemsProcessed(items);
+}
+
+void ArenaStringRows(BenchmarkState& state)
+{
+	static const std::vector<std::string> lines = GenerateArenaLines(1000);
+	CompiledFormat format(ArenaFmt);
+	StringArena arena;
+	std::vector<ArenaRow<ArenaString>> rows;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		rows.clear();
+		arena.Reset();
+		for (const auto& line : lines)
+		{
+			ArenaRow<ArenaString> row = { ArenaString(arena), ArenaString(arena), 0 };
+			if (format.Extract(line, row.name, row.email, row.age))
+				rows.push_back(row);
+		}
+		Benchmark::DoNotOptimize(rows);
+		items += lines.size();
+	}
+	state.SetItemsProcessed(items);
+}
+
+void ArenaAllocatorRows(BenchmarkState& state)
+{
+	typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> String;
+	static const std::vector<std::string> lines = GenerateArenaLines(1000);
+	CompiledFormat format(ArenaFmt);
+	StringArena arena;
+	std::vector<ArenaRow<String>> rows;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		rows.clear();
+		arena.Reset();
+		const ArenaAllocator<char> alloc(arena);
+		for (const auto& line : lines)
+		{
+			ArenaRow<String> row = { String(alloc), String(alloc), 0 };
+			if (format.Extract(line, row.name, row.email, row.age))
+				rows.push_back(std::move(row));
+		}
+		Benchmark::DoNotOptimize(rows);
+		items += lines.size();
+	}
+	state.SetItemsProcessed(items);
+}
+
+// Padded fields as printed by a fixed-column logger
+static const char* TrimFmt = "|{t}|{t}|{t: \"}|";
+static const std::string TrimInput = "|   Sherry Williams   |    20 |  \"sherry@example.com\"  |";
+
+// The untrimmed fields trimmed with the copies of DataTypeRef::TrimRight and
+// TrimLeft, as {t} used to be
+void TrimLegacy(BenchmarkState& state)
+{
+	CompiledFormat format("|{}|{}|{}|");
+	std::string name;
+	std::string ageText;
+	std::string email;
+	int age = 0;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		StringView fields[3];
+		format.Extract(TrimInput, fields[0], fields[1], fields[2]);
+		name = DataTypeRef::TrimLeft(DataTypeRef::TrimRight(fields[0].ToString(), " "), " ");
+		ageText = DataTypeRef::TrimLeft(DataTypeRef::TrimRight(fields[1].ToString(), " "), " ");
+		email = DataTypeRef::TrimLeft(DataTypeRef::TrimRight(fields[2].ToString(), " \""), " \"");
+		detail::ConvertTo(ageText, TokenType::Matter, age);
+		Benchmark::DoNotOptimize(age);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+template<typename String>
+void TrimFields(BenchmarkState& state)
+{
+	CompiledFormat format(TrimFmt);
+	String name;
+	int age = 0;
+	String email;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = format.Extract(TrimInput, name, age, email);
+		Benchmark::DoNotOptimize(result);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+// A user name of 64 bytes, all ASCII or with a non-ASCII letter in 8
+static const std::string Utf8Inputs[] = {
+	"Sherry Williams-Richardson of the Accounting Department, Floor 7",
+	"Zo\xC3\xAB \xC3\x85ngstr\xC3\xB6m M\xC3\xBCller-Sch\xC3\xA4" "fer, Bj\xC3\xB6rk Gu\xC3\xB0mundsd\xC3\xB3ttir",
+};
+
+// Widening byte by byte, as std::wstring fields used to be extracted
+template<int Input>
+void Utf8Legacy(BenchmarkState& state)
+{
+	const std::string& input = Utf8Inputs[Input];
+	std::wstring value;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		value = L"";
+		for (char ch : input)
+			value += (wchar_t)ch;
+		Benchmark::DoNotOptimize(value);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(items * input.size());
+}
+
+template<int Input, typename String>
+void Utf8Decode(BenchmarkState& state)
+{
+	const std::string& input = Utf8Inputs[Input];
+	String value;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractError error = detail::ConvertTo(input, TokenType::Matter, value);
+		Benchmark::DoNotOptimize(error);
+		Benchmark::DoNotOptimize(value);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(items * input.size());
+}
+
+// One field per destination type, extracted with a CompiledFormat
+static const char* DestFmt = "2025-01-01 12:00:00.001 Value:{}";
+static const char* DestHexFmt = "2025-01-01 12:00:00.001 Value:{h}";
+static const std::string DestInputs[] = {
+	"2025-01-01 12:00:00.001 Value:-123456",
+	"2025-01-01 12:00:00.001 Value:1234567890123",
+	"2025-01-01 12:00:00.001 Value:0x30ABCDEF",
+	"2025-01-01 12:00:00.001 Value:98765.4321",
+	"2025-01-01 12:00:00.001 Value:Sherry Williams-Richardson",
+};
+
+template<typename T, int Input, bool Hex = false>
+void ExtractDest(BenchmarkState& state)
+{
+	CompiledFormat format(Hex ? DestHexFmt : DestFmt);
+	T value = T();
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = format.Extract(DestInputs[Input], value);
+		Benchmark::DoNotOptimize(result);
+		Benchmark::DoNotOptimize(value);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+void ExtractDestArena(BenchmarkState& state)
+{
+	CompiledFormat format(DestFmt);
+	StringArena arena;
+	ArenaString value(arena);
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		if ((items & 1023) == 0)
+			arena.Reset();
+		ExtractResult result = format.Extract(DestInputs[4], value);
+		Benchmark::DoNotOptimize(result);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+// A generated log of four kinds of lines and some noise, each line tried
+// against the formats in turn, as a log ingester without a FormatSet does
+static const char* CorpusFmts[] = {
+	"REGISTER Name:{}, Age:{}",
+	"LOGIN UserName:{}, CustomerID:{h}",
+	"ORDER ID:{}, Amount:{}, Item:{t}",
+	"LOGOUT UserName:{}, Duration:{}ms",
+};
+
+std::vector<std::string> GenerateCorpus(size_t count)
+{
+	static const char* names[] = { "Sherry", "John", "Amy", "Bob", "Williams" };
+	static const char* items[] = { "Keyboard", "Mouse", "Monitor 27 inch", "USB-C Cable" };
+	std::mt19937 rng(2025);
+	std::vector<std::string> lines;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const std::string timestamp = "2025-01-01 12:" + std::to_string(10 + rng() % 50) + ":" + std::to_string(10 + rng() % 50) + ".001 ";
+		const std::string name = names[rng() % 5];
+		switch (rng() % 10)
+		{
+		case 0:
+		case 1:
+		case 2:
+			lines.push_back(timestamp + "REGISTER Name:" + name + ", Age:" + std::to_string(rng() % 100));
+			break;
+		case 3:
+		case 4:
+		case 5:
+			lines.push_back(timestamp + "LOGIN UserName:" + name + ", CustomerID:" + std::to_string(rng() % 100000));
+			break;
+		case 6:
+		case 7:
+			lines.push_back(timestamp + "ORDER ID:" + std::to_string(rng()) + ", Amount:" + std::to_string(rng() % 1000) + ".99, Item: " + items[rng() % 4] + " ");
+			break;
+		case 8:
+			lines.push_back(timestamp + "LOGOUT UserName:" + name + ", Duration:" + std::to_string(rng() % 100000) + "ms");
+			break;
+		default:
+			lines.push_back(timestamp + "HEARTBEAT Node:" + std::to_string(rng() % 16) + " OK");
+			break;
+		}
+	}
+	return lines;
+}
+
+static const std::vector<std::string>& Corpus()
+{
+	static const std::vector<std::string> lines = GenerateCorpus(10000);
+	return lines;
+}
+
+static size_t CorpusBytes()
+{
+	size_t bytes = 0;
+	for (const auto& line : Corpus())
+		bytes += line.size() + 1;
+	return bytes;
+}
+
+struct CorpusRecord
+{
+	StringView name;
+	int age;
+	uint32_t customerID;
+	uint64_t orderID;
+	double amount;
+	std::string item;
+	int duration;
+};
+
+template<typename... Args>
+bool CorpusTry(StringView line, const char* fmt, Args & ... args)
+{
+	return TryExtract(line, fmt, args...);
+}
+
+template<typename... Args>
+bool CorpusTry(StringView line, const std::vector<Token>& tokens, Args & ... args)
+{
+	return TryExtract(line, tokens, args...);
+}
+
+template<typename... Args>
+bool CorpusTry(StringView line, const CompiledFormat& format, Args & ... args)
+{
+	return format.TryExtract(line, args...);
+}
+
+template<typename Format>
+bool CorpusExtract(StringView line, const Format* formats, CorpusRecord& record)
+{
+	return CorpusTry(line, formats[0], record.name, record.age) ||
+		CorpusTry(line, formats[1], record.name, record.customerID) ||
+		CorpusTry(line, formats[2], record.orderID, record.amount, record.item) ||
+		CorpusTry(line, formats[3], record.name, record.duration);
+}
+
+template<typename Format>
+void CorpusLines(BenchmarkState& state, const Format* formats)
+{
+	const std::vector<std::string>& lines = Corpus();
+	CorpusRecord record = CorpusRecord();
+	size_t items = 0;
+	size_t matched = 0;
+	while (state.KeepRunning())
+	{
+		for (const auto& line : lines)
+			matched += CorpusExtract(line, formats, record);
+		items += lines.size();
+	}
+	Benchmark::DoNotOptimize(matched);
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(items / lines.size() * CorpusBytes());
+}
+
+void CorpusPerCallFmt(BenchmarkState& state)
+{
+	CorpusLines(state, CorpusFmts);
+}
+
+void CorpusPerCallFmtCached(BenchmarkState& state)
+{
+	EnableFormatCache();
+	CorpusLines(state, CorpusFmts);
+	EnableFormatCache(false);
+}
+
+void CorpusPreTokenized(BenchmarkState& state)
+{
+	std::vector<Token> tokens[4];
+	for (size_t i = 0; i < 4; ++i)
+		tokens[i] = TokenizeFmtString(CorpusFmts[i]);
+	CorpusLines(state, tokens);
+}
+
+void CorpusCompiled(BenchmarkState& state)
+{
+	CompiledFormat formats[4];
+	for (size_t i = 0; i < 4; ++i)
+		formats[i] = CompiledFormat(CorpusFmts[i]);
+	CorpusLines(state, formats);
+}
+
+// Classified with one FormatSet match, then converted
+void CorpusFormatSet(BenchmarkState& state)
+{
+	const std::vector<std::string>& lines = Corpus();
+	FormatSet formats;
+	for (const char* fmt : CorpusFmts)
+		formats.Add(fmt);
+	formats.Build();
+	FormatMatch match;
+	CorpusRecord record = CorpusRecord();
+	size_t items = 0;
+	size_t matched = 0;
+	while (state.KeepRunning())
+	{
+		for (const auto& line : lines)
+		{
+			if (formats.Match(line, match) == false)
+				continue;
+			switch (match.id)
+			{
+			case 0: matched += (bool)formats.Convert(match, record.name, record.age); break;
+			case 1: matched += (bool)formats.Convert(match, record.name, record.customerID); break;
+			case 2: matched += (bool)formats.Convert(match, record.orderID, record.amount, record.item); break;
+			case 3: matched += (bool)formats.Convert(match, record.name, record.duration); break;
+			}
+		}
+		items += lines.size();
+	}
+	Benchmark::DoNotOptimize(matched);
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(items / lines.size() * CorpusBytes());
+}
+
+// Only the REGISTER lines are kept, into columns
+void CorpusBatch(BenchmarkState& state)
+{
+	const std::vector<std::string>& lines = Corpus();
+	std::vector<StringView> views(lines.begin(), lines.end());
+	BatchExtractor batch(CorpusFmts[0], { ColumnType::String, ColumnType::Int64 });
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		batch.Clear();
+		batch.Extract(views);
+		Benchmark::DoNotOptimize(batch.GetColumn(1).int64s);
+		items += lines.size();
+	}
+	state.SetItemsProcessed(items);
+	state.SetBytesProcessed(items / lines.size() * CorpusBytes());
+}
+
+// A log line starting with its timestamp
+static const char* TimestampInput = "[2025-01-31 12:34:56.789012] GET /index.html";
+
+// Extracted as a string and parsed downstream with std::get_time
+void TimestampGetTime(BenchmarkState& state)
+{
+	CompiledFormat format("[{}] {}");
+	std::string text;
+	std::string request;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		format.Extract(TimestampInput, text, request);
+		std::tm tm = {};
+		std::istringstream stream(text);
+		stream >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+		std::time_t time = std::mktime(&tm);
+		Benchmark::DoNotOptimize(time);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+template<typename T>
+void TimestampLayout(BenchmarkState& state)
+{
+	CompiledFormat format("[{ts:%Y-%m-%d %H:%M:%S.%f}] {}");
+	T time;
+	std::string request;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = format.Extract(TimestampInput, time, request);
+		Benchmark::DoNotOptimize(result);
+		Benchmark::DoNotOptimize(time);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+// The client address of an access log line
+static const char* AddressFmts[] = { "{ip} - - {}", "[{ip6}] - - {}", "{mac} - - {}" };
+static const char* AddressInputs[] = {
+	"192.168.100.200 - - GET /index.html",
+	"[2001:db8:85a3::8a2e:370:7334] - - GET /index.html",
+	"00:1A:2B:3C:4D:5E - - GET /index.html",
+};
+
+// Extracted as a string and converted downstream with sscanf
+void AddressSscanf(BenchmarkState& state)
+{
+	CompiledFormat format("{} - - {}");
+	std::string text;
+	std::string request;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		format.Extract(AddressInputs[0], text, request);
+		unsigned parts[4] = {};
+		sscanf(text.c_str(), "%u.%u.%u.%u", &parts[0], &parts[1], &parts[2], &parts[3]);
+		uint32_t address = parts[0] << 24 | parts[1] << 16 | parts[2] << 8 | parts[3];
+		Benchmark::DoNotOptimize(address);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+template<int Input, typename T>
+void AddressExtract(BenchmarkState& state)
+{
+	CompiledFormat format(AddressFmts[Input]);
+	T address;
+	std::string request;
+	size_t items = 0;
+	while (state.KeepRunning())
+	{
+		ExtractResult result = format.Extract(AddressInputs[Input], address, request);
+		Benchmark::DoNotOptimize(result);
+		Benchmark::DoNotOptimize(address);
+		++items;
+	}
+	state.SetItemsProcessed(items);
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkAllocations::Enable();
+	values::SetStatsAllocationCounter(BenchmarkAllocations::Get);
+
+	// Startup cost of compiling a catalog of 5000 formats
+	Benchmark::Add("Tokenize", "Legacy", TokenizeLegacy);
+	Benchmark::Add("Tokenize", "SinglePass", TokenizeSinglePass);
+
+	// Per-call cost of the format for one line
+	Benchmark::Add("Extract", "PerCallFmt", ExtractPerCallFmt);
+	Benchmark::Add("Extract", "PerCallFmt.Cached", ExtractPerCallFmtCached);
+	Benchmark::Add("Extract", "PreTokenized", ExtractPreTokenized);
+	Benchmark::Add("Extract", "DataTypeRef", ExtractDataTypeRef);
+	Benchmark::Add("Extract", "Checked", ExtractChecked);
+	Benchmark::Add("Extract", "CheckedMismatch", ExtractCheckedMismatch);
+	Benchmark::Add("Extract", "Fused.MatchThenExtract", FusedMatchThenExtract);
+	Benchmark::Add("Extract", "Fused.TryExtract", FusedTryExtract);
+	Benchmark::Add("Extract", "Compiled", ExtractCompiled);
+#ifdef VALUES_HAS_CONSTEXPR14
+	Benchmark::Add("Extract", "CompileTime", ExtractCompileTime);
+#endif
+
+	// One field into each destination type
+	Benchmark::Add("Dest", "Int32", ExtractDest<int32_t, 0>);
+	Benchmark::Add("Dest", "Int64", ExtractDest<int64_t, 1>);
+	Benchmark::Add("Dest", "UInt32Hex", ExtractDest<uint32_t, 2, true>);
+	Benchmark::Add("Dest", "Double", ExtractDest<double, 3>);
+	Benchmark::Add("Dest", "String", ExtractDest<std::string, 4>);
+	Benchmark::Add("Dest", "StringView", ExtractDest<StringView, 4>);
+	Benchmark::Add("Dest", "WString", ExtractDest<std::wstring, 4>);
+	Benchmark::Add("Dest", "ArenaString", ExtractDestArena);
+
+	// 10000 generated log lines of four formats, ns/item is ns/line
+	Benchmark::Add("Corpus", "PerCallFmt", CorpusPerCallFmt);
+	Benchmark::Add("Corpus", "PerCallFmt.Cached", CorpusPerCallFmtCached);
+	Benchmark::Add("Corpus", "PreTokenized", CorpusPreTokenized);
+	Benchmark::Add("Corpus", "Compiled", CorpusCompiled);
+	Benchmark::Add("Corpus", "FormatSet", CorpusFormatSet);
+	Benchmark::Add("Corpus", "Batch", CorpusBatch);
+
+	// Field to number conversion per destination type
+	Benchmark::Add("Convert", "Int32Short.Legacy", ConvertLegacy<int32_t, 0, TokenType::Matter>);
+	Benchmark::Add("Convert", "Int32Short.Kernel", ConvertKernel<int32_t, 0, TokenType::Matter>);
+	Benchmark::Add("Convert", "Int64Long.Legacy", ConvertLegacy<int64_t, 1, TokenType::Matter>);
+	Benchmark::Add("Convert", "Int64Long.Kernel", ConvertKernel<int64_t, 1, TokenType::Matter>);
+	Benchmark::Add("Convert", "UInt64Long.Legacy", ConvertLegacy<uint64_t, 1, TokenType::Matter>);
+	Benchmark::Add("Convert", "UInt64Long.Kernel", ConvertKernel<uint64_t, 1, TokenType::Matter>);
+	Benchmark::Add("Convert", "UInt64Hex.Legacy", ConvertLegacy<uint64_t, 2, TokenType::Hex>);
+	Benchmark::Add("Convert", "UInt64Hex.Kernel", ConvertKernel<uint64_t, 2, TokenType::Hex>);
+	Benchmark::Add("Convert", "Float.Legacy", ConvertLegacy<float, 3, TokenType::Matter>);
+	Benchmark::Add("Convert", "Float.Kernel", ConvertKernel<float, 3, TokenType::Matter>);
+	Benchmark::Add("Convert", "Double.Legacy", ConvertLegacy<double, 3, TokenType::Matter>);
+	Benchmark::Add("Convert", "Double.Kernel", ConvertKernel<double, 3, TokenType::Matter>);
+
+	// Classification of a line against catalogs of 10 to 10,000 formats
+	Benchmark::Add("Classify", "Loop/00010", ClassifyLoop<10>);
+	Benchmark::Add("Classify", "Loop/00100", ClassifyLoop<100>);
+	Benchmark::Add("Classify", "Loop/01000", ClassifyLoop<1000>);
+	Benchmark::Add("Classify", "Loop/10000", ClassifyLoop<10000>);
+	Benchmark::Add("Classify", "FormatSet/00010", ClassifyFormatSet<10>);
+	Benchmark::Add("Classify", "FormatSet/00100", ClassifyFormatSet<100>);
+	Benchmark::Add("Classify", "FormatSet/01000", ClassifyFormatSet<1000>);
+	Benchmark::Add("Classify", "FormatSet/10000", ClassifyFormatSet<10000>);
+
+	// Delimiter search over log lines of 200 to 2000 bytes
+	AddSearchBenchmarks<200, 0>();
+	AddSearchBenchmarks<200, 1>();
+	AddSearchBenchmarks<200, 2>();
+	AddSearchBenchmarks<200, 3>();
+	AddSearchBenchmarks<2000, 0>();
+	AddSearchBenchmarks<2000, 1>();
+	AddSearchBenchmarks<2000, 2>();
+	AddSearchBenchmarks<2000, 3>();
+
+	// 1000 lines into columns, line by line or as a batch
+	Benchmark::Add("Batch", "PerLine", BatchPerLine);
+	Benchmark::Add("Batch", "Columns", BatchColumns);
+
+	// 32 MB of log on 1 to 8 worker threads (ns/item is per line)
+	Benchmark::Add("Engine", "Threads1", EngineRun<1, MergeOrder::Ordered>);
+	Benchmark::Add("Engine", "Threads2", EngineRun<2, MergeOrder::Ordered>);
+	Benchmark::Add("Engine", "Threads4", EngineRun<4, MergeOrder::Ordered>);
+	Benchmark::Add("Engine", "Threads8", EngineRun<8, MergeOrder::Ordered>);
+	Benchmark::Add("Engine", "Threads8.Unordered", EngineRun<8, MergeOrder::Unordered>);
+
+	// The same log from a std::istream with 4 KB to 1 MB blocks
+	Benchmark::Add("Stream", "Block4K", StreamRead<4 * 1024>);
+	Benchmark::Add("Stream", "Block64K", StreamRead<64 * 1024>);
+	Benchmark::Add("Stream", "Block1M", StreamRead<1024 * 1024>);
+
+	// Unanchored and anchored fmt on a matching and a non-matching line
+	Benchmark::Add("Anchor", "Hit.Search", AnchorMatch<0, 0>);
+	Benchmark::Add("Anchor", "Hit.Anchored", AnchorMatch<1, 0>);
+	Benchmark::Add("Anchor", "Miss.Search", AnchorMatch<0, 1>);
+	Benchmark::Add("Anchor", "Miss.Anchored", AnchorMatch<1, 1>);
+
+	// Fixed-width columns found by their postfix or sliced by width
+	Benchmark::Add("Width", "Search", WidthExtract<0>);
+	Benchmark::Add("Width", "Sliced", WidthExtract<1>);
+
+	// Fields ended by searching for a space or by their class
+	Benchmark::Add("Class", "Search", ClassExtract<0>);
+	Benchmark::Add("Class", "Digits", ClassExtract<1>);
+
+	// Adversarial lines of 1 KB to 1 MB
+	Benchmark::Add("Pathological", "Search/1K.StdFind", PathologicalSearch<1024, SearchMethod::StdFind>);
+	Benchmark::Add("Pathological", "Search/1K.Searcher", PathologicalSearch<1024, SearchMethod::Searcher>);
+	Benchmark::Add("Pathological", "Search/64K.StdFind", PathologicalSearch<64 * 1024, SearchMethod::StdFind>);
+	Benchmark::Add("Pathological", "Search/64K.Searcher", PathologicalSearch<64 * 1024, SearchMethod::Searcher>);
+	Benchmark::Add("Pathological", "Search/1M.Searcher", PathologicalSearch<1024 * 1024, SearchMethod::Searcher>);
+	Benchmark::Add("Pathological", "Extract/1K", PathologicalExtract<128>);
+	Benchmark::Add("Pathological", "Extract/64K", PathologicalExtract<8 * 1024>);
+	Benchmark::Add("Pathological", "Extract/1M", PathologicalExtract<128 * 1024>);
+
+	// String fields of 1000 rows kept until the next batch
+	Benchmark::Add("Arena", "Rows.StdString", ArenaStdString);
+	Benchmark::Add("Arena", "Rows.ArenaString", ArenaStringRows);
+	Benchmark::Add("Arena", "Rows.ArenaAllocator", ArenaAllocatorRows);
+
+	// Three padded fields, one of them a number
+	Benchmark::Add("Trim", "Legacy", TrimLegacy);
+	Benchmark::Add("Trim", "String", TrimFields<std::string>);
+	Benchmark::Add("Trim", "View", TrimFields<StringView>);
+
+	// A UTF-8 field of 64 bytes into a wide string
+	Benchmark::Add("Utf8", "Ascii.Legacy", Utf8Legacy<0>);
+	Benchmark::Add("Utf8", "Ascii.WString", Utf8Decode<0, std::wstring>);
+	Benchmark::Add("Utf8", "Ascii.U16String", Utf8Decode<0, std::u16string>);
+	Benchmark::Add("Utf8", "Mixed.Legacy", Utf8Legacy<1>);
+	Benchmark::Add("Utf8", "Mixed.WString", Utf8Decode<1, std::wstring>);
+	Benchmark::Add("Utf8", "Mixed.U16String", Utf8Decode<1, std::u16string>);
+
+	// The timestamp of a log line into a time_point
+	Benchmark::Add("Timestamp", "GetTime", TimestampGetTime);
+	Benchmark::Add("Timestamp", "TimePoint", TimestampLayout<std::chrono::system_clock::time_point>);
+	Benchmark::Add("Timestamp", "EpochNanoseconds", TimestampLayout<int64_t>);
+
+	// The address at the start of a log line into its bytes
+	Benchmark::Add("Address", "Ipv4.Sscanf", AddressSscanf);
+	Benchmark::Add("Address", "Ipv4", AddressExtract<0, uint32_t>);
+	Benchmark::Add("Address", "Ipv6", AddressExtract<1, std::array<uint8_t, 16> >);
+	Benchmark::Add("Address", "Mac", AddressExtract<2, std::array<uint8_t, 6> >);
+
+	// Lookups in a FormatCache shared by 1 or 8 threads
+	Benchmark::Add("Cache", "Threads1", CacheLookup<1>);
+	Benchmark::Add("Cache", "Threads8", CacheLookup<8>);
+
+	// Optional argument: only run the benchmarks whose name contains it
+	Benchmark::RunAll(argc > 1 ? argv[1] : nullptr);
+	return 0;
+}
@@ -0,0 +1,192 @@
+// The MIT License (MIT)
+// Benchmark harness of benchmark.cpp, part of the Values Extractor
+//
+// http://opensource.org/licenses/MIT
+
+#pragma once
+#include <vector>
+#include <functional>
+#include <map>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+
+// Allocations counted by a replaced operator new which calls Count(). The
+// allocs/item column is only shown once Enable() has been called.
+class BenchmarkAllocations
+{
+public:
+	static void Count()
+	{
+		Allocations.fetch_add(1, std::memory_order_relaxed);
+	}
+	static size_t Get()
+	{
+		return Allocations.load(std::memory_order_relaxed);
+	}
+	static void Enable()
+	{
+		Enabled = true;
+	}
+	static bool IsEnabled()
+	{
+		return Enabled;
+	}
+private:
+	static inline std::atomic<size_t> Allocations{ 0 };
+	static inline bool Enabled = false;
+};
+
+class BenchmarkState
+{
+public:
+	explicit BenchmarkState(size_t iterations)
+		: m_iterations(iterations)
+		, m_remaining(iterations)
+		, m_items(0)
+		, m_bytes(0)
+		, m_allocsBegin(0)
+		, m_allocsEnd(0)
+	{
+	}
+	// Loop condition of the benchmark body: while (state.KeepRunning()) { ... }
+	bool KeepRunning()
+	{
+		if (m_remaining == m_iterations)
+		{
+			m_allocsBegin = BenchmarkAllocations::Get();
+			m_begin = std::chrono::high_resolution_clock::now();
+		}
+		if (m_remaining == 0)
+		{
+			m_end = std::chrono::high_resolution_clock::now();
+			m_allocsEnd = BenchmarkAllocations::Get();
+			return false;
+		}
+		--m_remaining;
+		return true;
+	}
+	size_t Iterations() const
+	{
+		return m_iterations;
+	}
+	// Items (e.g. lines or formats) processed over all the iterations
+	void SetItemsProcessed(size_t items)
+	{
+		m_items = items;
+	}
+	// Bytes processed over all the iterations
+	void SetBytesProcessed(size_t bytes)
+	{
+		m_bytes = bytes;
+	}
+	size_t ItemsProcessed() const
+	{
+		return m_items;
+	}
+	size_t BytesProcessed() const
+	{
+		return m_bytes;
+	}
+	// Allocations made while the benchmark was running
+	size_t Allocations() const
+	{
+		return m_allocsEnd - m_allocsBegin;
+	}
+	double ElapsedNs() const
+	{
+		return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(m_end - m_begin).count();
+	}
+private:
+	size_t m_iterations;
+	size_t m_remaining;
+	size_t m_items;
+	size_t m_bytes;
+	size_t m_allocsBegin;
+	size_t m_allocsEnd;
+	std::chrono::high_resolution_clock::time_point m_begin;
+	std::chrono::high_resolution_clock::time_point m_end;
+};
+
+class Benchmark
+{
+public:
+	static void Add(const std::string& suite, const std::string& name, std::function<void(BenchmarkState&)> bench)
+	{
+		BenchList[suite].push_back(std::make_pair(name, bench));
+	}
+	// Run the benchmarks whose "suite.name" contains filter (all if filter is empty).
+	// Each benchmark is repeated with more iterations until it runs for MinTimeMs.
+	static void RunAll(const char* filter = nullptr)
+	{
+		printf("%-52s %14s %12s %14s %10s %12s\n", "Benchmark", "ns/iter", "iterations", "ns/item", "MB/s", "allocs/item");
+		printf("%s\n", std::string(119, '-').c_str());
+		for (auto& list : BenchList)
+		{
+			for (auto& pr : list.second)
+			{
+				std::string fullName = list.first + "." + pr.first;
+				if (filter && filter[0] && fullName.find(filter) == std::string::npos)
+					continue;
+
+				size_t iterations = 1;
+				while (true)
+				{
+					BenchmarkState state(iterations);
+					pr.second(state);
+					double ns = state.ElapsedNs();
+					if (ns >= MinTimeMs * 1e6 || iterations >= MaxIterations)
+					{
+						Report(fullName, state);
+						break;
+					}
+					double scale = (ns > 0.0) ? (MinTimeMs * 1.4e6 / ns) : 10.0;
+					if (scale > 10.0)
+						scale = 10.0;
+					if (scale < 1.5)
+						scale = 1.5;
+					iterations = (size_t)(iterations * scale);
+				}
+			}
+		}
+	}
+	static void SetMinTimeMs(double ms)
+	{
+		MinTimeMs = ms;
+	}
+	template<typename T>
+	static void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+private:
+	static void Report(const std::string& name, const BenchmarkState& state)
+	{
+		double ns = state.ElapsedNs();
+		double nsPerIter = ns / state.Iterations();
+		char perItem[32] = "-";
+		char mbps[32] = "-";
+		char allocs[32] = "-";
+		if (state.ItemsProcessed() > 0)
+			snprintf(perItem, sizeof(perItem), "%.2f", ns / state.ItemsProcessed());
+		if (state.BytesProcessed() > 0 && ns > 0.0)
+			snprintf(mbps, sizeof(mbps), "%.1f", (state.BytesProcessed() / (1024.0 * 1024.0)) / (ns / 1e9));
+		if (state.ItemsProcessed() > 0 && BenchmarkAllocations::IsEnabled())
+			snprintf(allocs, sizeof(allocs), "%.2f", (double)state.Allocations() / state.ItemsProcessed());
+
+		printf("%-52s %14.1f %12zu %14s %10s %12s\n", name.c_str(), nsPerIter, state.Iterations(), perItem, mbps, allocs);
+	}
+
+	static inline double MinTimeMs = 200.0;
+	static inline size_t MaxIterations = 1000000000;
+	static inline std::map<std::string,
+		std::vector<std::pair<std::string, std::function<void(BenchmarkState&)> > > > BenchList;
+};
@@ -1,7 +1,10 @@
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <cctype>
 #include "unittest.h"
 #include "values_extract.h"
+#include "values_file_extract.h"
 
 using namespace values;
 
@@ -106,6 +109,61 @@ void TrimString()
 	}
 }
 
+void TrimCharSet()
+{
+	const std::string input = "Name: \"Sherry William\" , Age:  20 , Code:0042|";
+
+	std::vector<Token> tokens = TokenizeFmtString("Name:{t: \"}, Age:{t}, Code:{4t:0}|");
+	CHECK(tokens.size(), == , 3u);
+	CHECK(tokens[0].trimChars, == , " \"");
+	CHECK(tokens[1].trimChars, == , "");
+	CHECK(tokens[2].trimChars, == , "0");
+	CHECK(tokens[2].width, == , 4u);
+
+	// the view is a slice of the input: nothing is copied
+	StringView name;
+	int age = 0;
+	int code = 0;
+	CHECK((bool)ValuesExtractChecked(input, tokens, name, age, code), == , true);
+	CHECK(name, == , StringView("Sherry William"));
+	CHECK(name.data, == , input.data() + 7);
+	CHECK(age, == , 20);
+	CHECK(code, == , 42);
+
+	std::string copy;
+	age = 0;
+	CHECK(TryExtract(input, tokens, copy, age, code), == , true);
+	CHECK(copy, == , "Sherry William");
+	CHECK(age, == , 20);
+
+	CompiledFormat format = tokens;
+	copy.clear();
+	age = 0;
+	CHECK((bool)format.Extract(input, copy, age, code), == , true);
+	CHECK(copy, == , "Sherry William");
+	CHECK(age, == , 20);
+
+	// a field of trimmed characters only is empty
+	CHECK(ValuesExtractChecked("Name:\"\", Age:20, Code:0000|", tokens, name, age, code).error == ExtractError::EmptyValue, == , true);
+	CHECK(name, == , StringView(""));
+
+	// the set replaces the whitespace: the spaces are kept with {t:"}
+	ValuesExtract("Name:\" Sherry \"", "Name:{t:\"}", copy);
+	CHECK(copy, == , " Sherry ");
+
+	// a colon is only allowed after t, and with characters to trim
+	CHECK(TokenizeFmtString("Name:{t:}").empty(), == , true);
+	CHECK(TokenizeFmtString("Name:{h:0}").empty(), == , true);
+
+#ifdef VALUES_HAS_CONSTEXPR14
+	name = StringView();
+	age = 0;
+	CHECK(ValuesExtract(input, VALUES_FMT("Name:{t: \"}, Age:{t}, Code:{x}"), name, age), == , true);
+	CHECK(name, == , StringView("Sherry William"));
+	CHECK(age, == , 20);
+#endif
+}
+
 void HexString()
 {
 	const char* fmt = "Binary:{h}";
@@ -547,6 +605,1610 @@ void LastEmptyTokenized()
 	}
 }
 
+void StringViewTest()
+{
+	const char* fmt = "Name:{t}, Gender:{}, Salary:{}";
+
+	const std::string input = "Name:  Sherry William  , Gender:F, Salary:3600";
+
+	StringView Name;
+
+	StringView Gender;
+
+	int Salary = 0;
+
+	std::vector<Token> tokens = TokenizeFmtString(fmt);
+
+	bool isMatched = IsInputMatchedTokens(input, tokens);
+
+	CHECK(isMatched, == , true);
+
+	if (isMatched)
+	{
+		ValuesExtract(input, tokens, Name, Gender, Salary);
+
+		CHECK(Name, == , "Sherry William");
+
+		CHECK(Gender, == , "F");
+
+		CHECK(Salary, == , 3600);
+
+		// views point into the input, no copy is made
+		CHECK(Name.data, == , input.data() + 7);
+	}
+}
+
+void TokenizeMixedSpecifiers()
+{
+	const char* fmt = "CustID:{x}, Name:{t}, Binary:{h}, Age:{}";
+
+	std::vector<Token> tokens = TokenizeFmtString(fmt);
+
+	CHECK(tokens.size(), == , 4u);
+
+	if (tokens.size() == 4)
+	{
+		CHECK(tokens[0].type == TokenType::None, == , true);
+		CHECK(tokens[0].index, == , -1);
+		CHECK(tokens[0].prefix, == , "CustID:");
+		CHECK(tokens[0].postfix, == , ", Name:");
+
+		CHECK(tokens[1].type == TokenType::Trim, == , true);
+		CHECK(tokens[1].index, == , 0);
+		CHECK(tokens[1].prefix, == , ", Name:");
+		CHECK(tokens[1].postfix, == , ", Binary:");
+
+		CHECK(tokens[2].type == TokenType::Hex, == , true);
+		CHECK(tokens[2].index, == , 1);
+		CHECK(tokens[2].start, == , 29u);
+
+		CHECK(tokens[3].type == TokenType::Matter, == , true);
+		CHECK(tokens[3].index, == , 2);
+		CHECK(tokens[3].prefix, == , ", Age:");
+		CHECK(tokens[3].postfix, == , "");
+	}
+}
+
+void TokenizeSideBySide()
+{
+	std::vector<Token> tokens = TokenizeFmtString("ID:{}{h}");
+
+	CHECK(tokens.empty(), == , true);
+
+	// braces which are not specifiers are literal text
+	tokens = TokenizeFmtString("{ID}:{}");
+
+	CHECK(tokens.size(), == , 1u);
+
+	if (tokens.size() == 1)
+	{
+		CHECK(tokens[0].prefix, == , "{ID}:");
+	}
+}
+
+void DataTypeRefTokenized()
+{
+	const char* fmt = "Name:{t}, Gender:{}, Salary:{}";
+
+	const std::string input = "Name:  Sherry William  , Gender:F, Salary:3600";
+
+	std::string Name;
+
+	char Gender = 'A';
+
+	int Salary = 0;
+
+	std::vector<Token> tokens = TokenizeFmtString(fmt);
+
+	// runtime-typed destinations
+	std::vector<DataTypeRef> results;
+	results.push_back(DataTypeRef(Name));
+	results.push_back(DataTypeRef(Gender));
+	results.push_back(DataTypeRef(Salary));
+
+	detail::ValuesExtractHelp(input, tokens, results);
+
+	CHECK(Name, == , "Sherry William");
+
+	CHECK(Gender, == , 'F');
+
+	CHECK(Salary, == , 3600);
+}
+
+void IntegerKernels()
+{
+	const char* inputs[] = { "0", "7", "-7", "+42", "  123", "12345678", "123456789012345678",
+		"9223372036854775807", "-9223372036854775808", "00000000000000000000001",
+		"3600abc", "1234567a", "-0" };
+
+	for (const char* input : inputs)
+	{
+		int64_t i64 = 0;
+		detail::ConvertTo(input, TokenType::Matter, i64);
+		CHECK(i64, == , (int64_t)strtoll(input, nullptr, 10));
+
+		// out of range values are rejected and leave the destination unchanged
+		long long expected = strtoll(input, nullptr, 10);
+		uint64_t u64 = 0;
+		ExtractError error = detail::ConvertTo(input, TokenType::Matter, u64);
+		CHECK(u64, == , (expected < 0) ? 0 : (uint64_t)strtoull(input, nullptr, 10));
+		CHECK(error == ExtractError::OutOfRange, == , expected < 0);
+
+		int32_t i32 = 0;
+		error = detail::ConvertTo(input, TokenType::Matter, i32);
+		bool fits = (expected >= INT32_MIN && expected <= INT32_MAX);
+		CHECK(i32, == , fits ? (int32_t)expected : 0);
+		CHECK(error == ExtractError::OutOfRange, == , fits == false);
+	}
+
+	uint64_t max64 = 0;
+	detail::ConvertTo("18446744073709551615", TokenType::Matter, max64);
+	CHECK(max64, == , UINT64_MAX);
+
+	const char* hexInputs[] = { "0", "A", "a", "0xA", "0XfF", "ffffffff", "7fffffffffffffff", "0x", "12g" };
+
+	for (const char* input : hexInputs)
+	{
+		uint64_t u64 = 0;
+		detail::ConvertTo(input, TokenType::Hex, u64);
+		CHECK(u64, == , (uint64_t)strtoull(input, nullptr, 16));
+	}
+}
+
+void Utf8Strings()
+{
+	// "Zoë Ångström" and U+1F600, which takes a surrogate pair in UTF-16
+	const std::string name = "Zo\xC3\xAB \xC3\x85ngstr\xC3\xB6m";
+	const std::string input = "Name:" + name + ", Mood:\xF0\x9F\x98\x80, Sign:\xE2\x82\xAC";
+
+	std::wstring wname;
+	std::u16string mood16;
+	std::u32string mood32;
+	wchar_t sign = 0;
+	CHECK((bool)ValuesExtractChecked(input, "Name:{}, Mood:{}, Sign:{}", wname, mood16, sign), == , true);
+	CHECK(wname == L"Zo\u00EB \u00C5ngstr\u00F6m", == , true);
+	CHECK(mood16 == std::u16string(u"\xD83D\xDE00"), == , true);
+	CHECK(static_cast<uint32_t>(sign), == , 0x20ACu);
+	CHECK((bool)ValuesExtractChecked(input, "Name:{x}, Mood:{}, Sign:{x}", mood32), == , true);
+	CHECK(mood32 == std::u32string(U"\U0001F600"), == , true);
+
+	// longer than a SIMD block, with the non-ASCII byte in the second block
+	std::u32string long32;
+	const std::string longInput = std::string(40, 'a') + "\xC3\xA9" + std::string(20, 'b');
+	CHECK((bool)ValuesExtractChecked(longInput, "{}", long32), == , true);
+	CHECK(long32 == std::u32string(40, U'a') + U"\u00E9" + std::u32string(20, U'b'), == , true);
+
+	// the invalid sequences are replaced by U+FFFD and reported
+	const char* invalid[] = { "\xC3(", "\xC0\xAF", "\xED\xA0\x80", "\xE2\x82", "\xF4\x90\x80\x80", "\x80" };
+	for (const char* text : invalid)
+	{
+		std::u32string value;
+		CHECK(ValuesExtractChecked(text, "{}", value).error == ExtractError::InvalidEncoding, == , true);
+		CHECK(value.empty() == false && value[0] == 0xFFFD, == , true);
+	}
+
+	// all or nothing: an invalid sequence leaves the parameters untouched
+	wname = L"unchanged";
+	int age = -1;
+	CHECK(TryExtract("Name:\xFF, Age:20", "Name:{}, Age:{}", wname, age), == , false);
+	CHECK(wname == L"unchanged", == , true);
+	CHECK(age, == , -1);
+
+	// one code point for a wchar_t
+	CHECK(ValuesExtractChecked("\xE2\x82\xACx", "{}", sign).error == ExtractError::TrailingChars, == , true);
+	CHECK(ValuesExtractChecked("\xE2\x82", "{}", sign).error == ExtractError::InvalidEncoding, == , true);
+
+	std::u16string viaRef;
+	std::vector<DataTypeRef> results;
+	detail::AddData(results, viaRef);
+	detail::ValuesExtractHelp("Name:" + name, TokenizeFmtString("Name:{}"), results);
+	CHECK(viaRef == std::u16string(u"Zo\u00EB \u00C5ngstr\u00F6m"), == , true);
+}
+
+void Timestamps()
+{
+	std::vector<Token> tokens = TokenizeFmtString("[{ts:%Y-%m-%d %H:%M:%S.%f}] {}");
+	CHECK(tokens.size(), == , 2u);
+	CHECK(tokens[0].type == TokenType::Timestamp, == , true);
+	CHECK(tokens[0].layout, == , "%Y-%m-%d %H:%M:%S.%f");
+
+	int64_t nanoseconds = 0;
+	std::string message;
+	CHECK((bool)ValuesExtractChecked("[2024-02-29 12:34:56.789] started", tokens, nanoseconds, message), == , true);
+	CHECK(nanoseconds, == , 1709210096789000000LL);
+	CHECK(message, == , "started");
+
+	// the fraction is optional at the end of the layout, up to 9 digits
+	CHECK((bool)ValuesExtractChecked("[2024-02-29 12:34:56] started", tokens, nanoseconds, message), == , true);
+	CHECK(nanoseconds, == , 1709210096000000000LL);
+	CHECK((bool)ValuesExtractChecked("[2000-01-01 00:00:00.000000001] x", tokens, nanoseconds, message), == , true);
+	CHECK(nanoseconds, == , 946684800000000001LL);
+	CHECK((bool)ValuesExtractChecked("[1969-12-31 23:59:59.5] x", tokens, nanoseconds, message), == , true);
+	CHECK(nanoseconds, == , -500000000LL);
+
+	// the default layout, and another one
+	std::chrono::system_clock::time_point time;
+	CHECK(TryExtract("at 2024-02-29 12:34:56", "at {ts}", time), == , true);
+	CHECK(std::chrono::system_clock::to_time_t(time), == , 1709210096);
+	CHECK(TryExtract("[10/03/2024:14:05:00 +0000]", "[{ts:%d/%m/%Y:%H:%M:%S} +0000]", nanoseconds), == , true);
+	CHECK(nanoseconds, == , 1710079500000000000LL);
+
+	std::chrono::time_point<std::chrono::system_clock, std::chrono::milliseconds> millis;
+	CompiledFormat format("{ts:%Y%m%dT%H%M%S.%f}Z");
+	CHECK(format.TryExtract("20240229T123456.789Z", millis), == , true);
+	CHECK(millis.time_since_epoch().count(), == , 1709210096789LL);
+
+	// a {} field into a time_point has the default layout
+	CHECK(TryExtract("2024-02-29 12:34:56.5", "{}", time), == , true);
+	CHECK(std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count(), == , 1709210096500LL);
+
+	const char* invalid[] = { "2024-13-01 00:00:00", "2023-02-29 00:00:00", "2024-01-01 24:00:00", "2024-01-01 00:60:00" };
+	for (const char* text : invalid)
+		CHECK(ValuesExtractChecked(text, "{ts}", nanoseconds).error == ExtractError::OutOfRange, == , true);
+	CHECK(ValuesExtractChecked("2024-1-01 00:00:00", "{ts}", nanoseconds).error == ExtractError::InvalidValue, == , true);
+	CHECK(ValuesExtractChecked("2024-01-01 00:00:00.", "{ts}", nanoseconds).error == ExtractError::InvalidValue, == , true);
+	CHECK(ValuesExtractChecked("2024-01-01 00:00:00Z", "{ts}{$}", nanoseconds).error == ExtractError::PostfixNotFound, == , true);
+	CHECK(ValuesExtractChecked("2300-01-01 00:00:00", "{ts}", nanoseconds).error == ExtractError::OutOfRange, == , true);
+
+	// an unknown conversion is not a specifier
+	CHECK(TokenizeFmtString("{ts:%Y %j}").empty(), == , true);
+	CHECK(TryExtract("12:30ok", "{ts:%H:%M}{}", nanoseconds, message), == , true);
+	CHECK(nanoseconds, == , (12 * 60 + 30) * 60 * 1000000000LL);
+	CHECK(message, == , "ok");
+
+	// same as timegm over the years
+	uint32_t seed = 1;
+	for (int i = 0; i < 1000; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		const int64_t seconds = static_cast<int64_t>(seed % 8000000000u) - 2000000000;
+		const std::time_t t = static_cast<std::time_t>(seconds);
+		std::tm tm = *gmtime(&t);
+		char text[32];
+		strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm);
+		CHECK(TryExtract(text, "{ts}", nanoseconds), == , true);
+		CHECK(nanoseconds, == , seconds * 1000000000);
+	}
+}
+
+void Addresses()
+{
+	// the fields end at the first character out of their class
+	uint32_t client = 0;
+	std::array<uint8_t, 16> server = {};
+	std::array<uint8_t, 6> device = {};
+	const char* input = "client=192.168.1.20:443 server=[2001:db8::ff00:42:8329] device=00:1A:2b:3C:4d:5E;";
+	CHECK((bool)ValuesExtractChecked(input, "client={ip}:{x} server=[{ip6}] device={mac};", client, server, device), == , true);
+	CHECK(client, == , 0xC0A80114u);
+	const std::array<uint8_t, 16> expected6 = { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0xff, 0x00, 0x00, 0x42, 0x83, 0x29 } };
+	CHECK(server == expected6, == , true);
+	const std::array<uint8_t, 6> expectedMac = { { 0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x5E } };
+	CHECK(device == expectedMac, == , true);
+
+	// side by side, as their end is known
+	std::string rest;
+	CHECK(TryExtract("10.0.0.1GET", "{ip}{}", client, rest), == , true);
+	CHECK(client, == , 0x0A000001u);
+	CHECK(rest, == , "GET");
+
+	// the other forms
+	CHECK(TryExtract("0011.2233.4455", "{mac}", device), == , true);
+	CHECK(device[5], == , 0x55);
+	CHECK(TryExtract("00-11-22-33-44-AA", "{mac}", device), == , true);
+	CHECK(device[5], == , 0xAA);
+
+	struct Case
+	{
+		const char* text;
+		std::array<uint8_t, 16> bytes;
+	};
+	const Case cases[] = {
+		{ "::", { {} } },
+		{ "::1", { { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 } } },
+		{ "1::", { { 0, 1 } } },
+		{ "1:2:3:4:5:6:7:8", { { 0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6, 0, 7, 0, 8 } } },
+		{ "1:2:3:4:5:6:7::", { { 0, 1, 0, 2, 0, 3, 0, 4, 0, 5, 0, 6, 0, 7, 0, 0 } } },
+		{ "::ffff:10.0.0.1", { { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 10, 0, 0, 1 } } },
+		{ "FE80::0202:B3FF:FE1E:8329", { { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0x02, 0x02, 0xb3, 0xff, 0xfe, 0x1e, 0x83, 0x29 } } },
+	};
+	for (const Case& c : cases)
+	{
+		std::array<uint8_t, 16> bytes;
+		CHECK(TryExtract(c.text, "{ip6}", bytes), == , true);
+		CHECK(bytes == c.bytes, == , true);
+	}
+
+	const char* invalid6[] = { ":", ":1", "1:", "1:::2", "1::2::3", "1:2:3:4:5:6:7:8:9", "1:2:3:4:5:6:7:8::", "12345::", "1:2:3:4:5:6:7", "::1.2.3", "1.2.3.4" };
+	for (const char* text : invalid6)
+	{
+		std::array<uint8_t, 16> bytes;
+		CHECK(ValuesExtractChecked(text, "{ip6}", bytes).error != ExtractError::None, == , true);
+	}
+
+	const char* invalid4[] = { "1.2.3", "1.2.3.4.5", "01.2.3.4", "1..2.3", "1.2.3.", "" };
+	for (const char* text : invalid4)
+		CHECK(ValuesExtractChecked(std::string("[") + text + "]", "[{ip}]", client).error != ExtractError::None, == , true);
+	CHECK(ValuesExtractChecked("256.0.0.1", "{ip}", client).error == ExtractError::OutOfRange, == , true);
+
+	const char* invalidMac[] = { "00:11:22:33:44", "00:11:22-33:44:55", "00:11:22:33:44:5G", "0011.2233.445", "00:11:22:33:44:55:66" };
+	for (const char* text : invalidMac)
+		CHECK(ValuesExtractChecked(text, "{mac}", device).error != ExtractError::None, == , true);
+
+	// into other integers, when the address fits
+	int64_t wide = 0;
+	int32_t narrow = 0;
+	CHECK(TryExtract("255.255.255.255", "{ip}", wide), == , true);
+	CHECK(wide, == , 0xFFFFFFFFLL);
+	CHECK(ValuesExtractChecked("255.255.255.255", "{ip}", narrow).error == ExtractError::OutOfRange, == , true);
+}
+
+// Extracts a field the same through the tokens, DataTypeRef, a
+// CompiledFormat and a FormatSet
+template<typename T>
+void CheckFieldPaths(const std::string& input, const char* fmt, const T& expected)
+{
+	T value = T();
+	CHECK((bool)ValuesExtractChecked(input, TokenizeFmtString(fmt), value), == , true);
+	CHECK(value == expected, == , true);
+
+	value = T();
+	std::vector<DataTypeRef> results;
+	results.push_back(DataTypeRef(value));
+	detail::ValuesExtractHelp(input, TokenizeFmtString(fmt), results);
+	CHECK(value == expected, == , true);
+
+	value = T();
+	CompiledFormat format(fmt);
+	CHECK(format.TryExtract(input, value), == , true);
+	CHECK(value == expected, == , true);
+
+	value = T();
+	FormatSet formats;
+	formats.Add(fmt);
+	formats.Build();
+	FormatMatch match;
+	CHECK(formats.Match(input, match), == , true);
+	CHECK((bool)formats.Convert(match, value), == , true);
+	CHECK(value == expected, == , true);
+}
+
+// and into an Int64 column of a BatchExtractor
+void CheckFieldPaths(const std::string& input, const char* fmt, int64_t expected)
+{
+	CheckFieldPaths<int64_t>(input, fmt, expected);
+
+	BatchExtractor batch(TokenizeFmtString(fmt), { ColumnType::Int64 });
+	std::vector<StringView> lines = { input, "no match" };
+	batch.Extract(lines);
+	CHECK(batch.GetColumn(0).IsValid(0), == , true);
+	CHECK(batch.GetColumn(0).int64s[0], == , expected);
+	CHECK(batch.GetColumn(0).IsValid(1), == , false);
+}
+
+void FieldPaths()
+{
+	const std::array<uint8_t, 16> server = { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0xff, 0x00, 0x00, 0x42, 0x83, 0x29 } };
+	const std::array<uint8_t, 6> device = { { 0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x5E } };
+
+	// the {ts} field ends where its layout does, before the postfix ' '
+	CheckFieldPaths("at 2000-01-01 00:00:01 ok", "at {ts} ok", int64_t(946684801000000000));
+	CheckFieldPaths("at 2000/01/02;", "at {ts:%Y/%m/%d};", std::chrono::system_clock::from_time_t(946771200));
+	CheckFieldPaths("client=192.168.1.20:443", "client={ip}:", int64_t(0xC0A80114));
+	CheckFieldPaths("client=192.168.1.20:443", "client={ip}:", 0xC0A80114u);
+	CheckFieldPaths("server=[2001:db8::ff00:42:8329]", "server=[{ip6}]", server);
+	CheckFieldPaths("device=00:1A:2b:3C:4d:5E;", "device={mac};", device);
+
+#ifdef VALUES_HAS_CONSTEXPR14
+	int64_t nanoseconds = 0;
+	std::chrono::system_clock::time_point time;
+	uint32_t client = 0;
+	std::array<uint8_t, 16> bytes6 = {};
+	std::array<uint8_t, 6> mac = {};
+	CHECK(ValuesExtract("at 2000-01-01 00:00:01 ok", VALUES_FMT("at {ts} ok"), nanoseconds), == , true);
+	CHECK(nanoseconds, == , 946684801000000000LL);
+	CHECK(ValuesExtract("at 2000/01/02;", VALUES_FMT("at {ts:%Y/%m/%d};"), time), == , true);
+	CHECK(std::chrono::system_clock::to_time_t(time), == , 946771200);
+	CHECK(ValuesExtract("client=192.168.1.20:443 server=[2001:db8::ff00:42:8329] device=00:1A:2b:3C:4d:5E;",
+		VALUES_FMT("client={ip}:{x} server=[{ip6}] device={mac};"), client, bytes6, mac), == , true);
+	CHECK(client, == , 0xC0A80114u);
+	CHECK(bytes6 == server, == , true);
+	CHECK(mac == device, == , true);
+#endif
+}
+
+void FloatKernels()
+{
+	const char* inputs[] = { "0", "-0", "1", "3.14", "-2.5e-3", "1e22", "1e23", "123456789012345678901234",
+		"0.1", "2.2250738585072014e-308", "4.9e-324", "1.7976931348623157e308", "1e400", "  12.5kg",
+		"0x1p3", "inf", "-nan", ".5", "5.", "1e", "1e+", "9007199254740993" };
+
+	for (const char* input : inputs)
+	{
+		// overflow is reported instead of storing infinity
+		bool infLiteral = (strstr(input, "inf") != nullptr);
+		double d = 0;
+		ExtractError error = detail::ConvertTo(input, TokenType::Matter, d);
+		double expected = strtod(input, nullptr);
+		if (std::isinf(expected) && infLiteral == false)
+		{
+			CHECK(error == ExtractError::OutOfRange, == , true);
+			expected = 0;
+		}
+		CHECK(memcmp(&d, &expected, sizeof(d)) == 0 || (d != d && expected != expected), == , true);
+
+		float f = 0;
+		error = detail::ConvertTo(input, TokenType::Matter, f);
+		float expectedf = strtof(input, nullptr);
+		if (std::isinf(expectedf) && infLiteral == false)
+		{
+			CHECK(error == ExtractError::OutOfRange, == , true);
+			expectedf = 0;
+		}
+		CHECK(memcmp(&f, &expectedf, sizeof(f)) == 0 || (f != f && expectedf != expectedf), == , true);
+	}
+
+	// random decimals must round exactly like strtod
+	uint64_t seed = 88172645463325252ULL;
+	for (int i = 0; i < 20000; ++i)
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		char buf[64];
+		snprintf(buf, sizeof(buf), "%llu.%llue%d", (unsigned long long)(seed % 100000000),
+			(unsigned long long)((seed >> 27) % 10000000), (int)((seed >> 50) % 40) - 20);
+
+		double d = 0;
+		detail::ConvertTo(buf, TokenType::Matter, d);
+		CHECK(d, == , strtod(buf, nullptr));
+
+		float f = 0;
+		detail::ConvertTo(buf, TokenType::Matter, f);
+		CHECK(f, == , strtof(buf, nullptr));
+	}
+}
+
+void CheckedSuccess()
+{
+	const char* fmt = "LOGIN UserName:{}, CustomerID:{h}, Age:{}";
+
+	const std::string input = "LOGIN UserName:Sherry Williams, CustomerID:30AB, Age:20";
+
+	std::string name;
+	int custID = 0;
+	short age = 0;
+
+	ExtractResult result = ValuesExtractChecked(input, fmt, name, custID, age);
+
+	CHECK((bool)result, == , true);
+	CHECK(result.token, == , -1);
+	CHECK(name, == , "Sherry Williams");
+	CHECK(custID, == , 0x30AB);
+	CHECK(age, == , 20);
+}
+
+void CheckedDelimiterNotFound()
+{
+	std::vector<Token> tokens = TokenizeFmtString("Name:{}, Age:{}");
+
+	std::string name;
+	int age = 0;
+
+	ExtractResult result = ValuesExtractChecked("Gender:F, Age:20", tokens, name, age);
+	CHECK(result.error == ExtractError::PrefixNotFound, == , true);
+	CHECK(result.token, == , 0);
+	CHECK(result.offset, == , 0u);
+
+	result = ValuesExtractChecked("Name:Sherry Age:20", tokens, name, age);
+	CHECK(result.error == ExtractError::PostfixNotFound, == , true);
+	CHECK(result.token, == , 0);
+	CHECK(result.offset, == , 5u);
+	CHECK(name.empty(), == , true);
+
+	result = ValuesExtractChecked("Name:Sherry, Age:20", tokens, name);
+	CHECK(result.error == ExtractError::ArgCountMismatch, == , true);
+}
+
+void CheckedConversionErrors()
+{
+	const char* fmt = "ID:{}, Count:{}";
+
+	int id = 0;
+	short count = 7;
+
+	ExtractResult result = ValuesExtractChecked("ID:12, Count:40000", fmt, id, count);
+	CHECK(result.error == ExtractError::OutOfRange, == , true);
+	CHECK(result.token, == , 1);
+	CHECK(result.offset, == , 13u);
+	CHECK(id, == , 12);
+	CHECK(count, == , 7);
+
+	result = ValuesExtractChecked("ID:12kg, Count:4", fmt, id, count);
+	CHECK(result.error == ExtractError::TrailingChars, == , true);
+	CHECK(result.token, == , 0);
+	CHECK(result.offset, == , 3u);
+
+	result = ValuesExtractChecked("ID:ab, Count:4", fmt, id, count);
+	CHECK(result.error == ExtractError::InvalidValue, == , true);
+
+	unsigned int uid = 0;
+	result = ValuesExtractChecked("ID:-1", "ID:{}", uid);
+	CHECK(result.error == ExtractError::OutOfRange, == , true);
+
+	// a hexadecimal value may use the sign bit
+	int hex = 0;
+	result = ValuesExtractChecked("ID:FFFFFFFF", "ID:{h}", hex);
+	CHECK((bool)result, == , true);
+	CHECK(hex, == , -1);
+
+	result = ValuesExtractChecked("ID:1FFFFFFFF", "ID:{h}", hex);
+	CHECK(result.error == ExtractError::OutOfRange, == , true);
+
+	double d = 1.0;
+	result = ValuesExtractChecked("ID:1e400", "ID:{}", d);
+	CHECK(result.error == ExtractError::OutOfRange, == , true);
+	CHECK(d, == , 1.0);
+}
+
+void SearchMatchesFind()
+{
+	// a small alphabet gives many partial matches of the delimiters
+	const char alphabet[] = "ab:, ";
+	uint64_t seed = 88172645463325252ULL;
+	auto random = [&seed]()
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return (size_t)seed;
+	};
+	for (int i = 0; i < 5000; ++i)
+	{
+		std::string input(random() % 300, ' ');
+		for (auto& ch : input)
+			ch = alphabet[random() % 5];
+		std::string find(1 + random() % 6, ' ');
+		for (auto& ch : find)
+			ch = alphabet[random() % 5];
+		size_t pos = random() % (input.size() + 2);
+
+		detail::Searcher searcher = detail::MakeSearcher(find);
+		CHECK(detail::Search(input, find, searcher, pos), == , input.find(find, pos));
+		// a searcher of another delimiter is not used
+		CHECK(detail::Search(input, find, detail::MakeSearcher("abcdefg"), pos), == , input.find(find, pos));
+	}
+}
+
+void SearcherAnchors()
+{
+	// the rarest bytes of ", CustomerID:" are the capitals, not the
+	// separators which are everywhere in log lines
+	detail::Searcher searcher = detail::MakeSearcher(", CustomerID:");
+	CHECK(searcher.size, == , 13u);
+	CHECK(searcher.offset1, == , 2u);
+	CHECK(searcher.offset2, == , 11u);
+
+	std::vector<Token> tokens = TokenizeFmtString("LOGIN UserName:{}, CustomerID:{h}");
+	CHECK(tokens[0].postfixSearcher.size, == , tokens[0].postfix.size());
+	CHECK(tokens[1].prefixSearcher.size, == , tokens[1].prefix.size());
+}
+
+void BatchColumns()
+{
+	BatchExtractor batch("REGISTER Name:{t}, Age:{}, Score:{}, ID:{h}",
+		{ ColumnType::String, ColumnType::Int64, ColumnType::Double, ColumnType::Int64 });
+
+	std::vector<StringView> lines;
+	lines.push_back("2025-01-01 12:00:00.001 REGISTER Name: Sherry , Age:20, Score:12.5, ID:30AB");
+	lines.push_back("2025-01-01 12:00:00.002 LOGIN UserName:Sherry");
+	lines.push_back("REGISTER Name:John, Age:twenty, Score:7, ID:ff");
+
+	size_t matched = batch.Extract(lines);
+	CHECK(matched, == , 2u);
+	CHECK(batch.Rows(), == , 3u);
+
+	const Column& names = batch.GetColumn(0);
+	CHECK(names.String(0).ToString(), == , "Sherry");
+	CHECK(names.IsValid(0), == , true);
+	CHECK(names.IsValid(1), == , false);
+	CHECK(names.String(1).empty(), == , true);
+	CHECK(names.String(2).ToString(), == , "John");
+	CHECK(names.offsets.size(), == , 4u);
+	CHECK(names.offsets[3], == , static_cast<uint64_t>(names.bytes.size()));
+
+	const Column& ages = batch.GetColumn(1);
+	CHECK(ages.int64s.size(), == , 3u);
+	CHECK(ages.int64s[0], == , 20);
+	CHECK(ages.IsValid(2), == , false);
+
+	CHECK(batch.GetColumn(2).doubles[0], == , 12.5);
+	CHECK(batch.GetColumn(3).int64s[2], == , 0xff);
+
+	// a buffer with line offsets appends to the same columns
+	const std::string buffer = "REGISTER Name:Amy, Age:30, Score:1, ID:1\nREGISTER Name:Bob, Age:40, Score:2, ID:2\n";
+	std::vector<size_t> offsets = { 0, buffer.find('\n') + 1, buffer.size() };
+	CHECK(batch.Extract(buffer, offsets), == , 2u);
+	CHECK(batch.Rows(), == , 5u);
+	CHECK(batch.GetColumn(3).int64s[4], == , 2);
+	CHECK(batch.GetColumn(0).String(3).ToString(), == , "Amy");
+
+	// "\r\n" ends a line as well, the last field has no '\r'
+	const std::string crlf = "REGISTER Name:Cat, Age:50, Score:3, ID:3\r\nREGISTER Name:Dan, Age:60, Score:4, ID:4\r\n";
+	offsets = { 0, crlf.find('\n') + 1, crlf.size() };
+	CHECK(batch.Extract(crlf, offsets), == , 2u);
+	CHECK(batch.GetColumn(3).IsValid(5), == , true);
+	CHECK(batch.GetColumn(3).IsValid(6), == , true);
+	CHECK(batch.GetColumn(3).int64s[6], == , 4);
+
+	batch.Clear();
+	CHECK(batch.Rows(), == , 0u);
+}
+
+struct RegisterRow
+{
+	StringView name;
+	int age;
+};
+
+bool ExtractRegister(StringView line, const std::vector<Token>& tokens, RegisterRow& row)
+{
+	return (bool)ValuesExtractChecked(line, tokens, row.name, row.age);
+}
+
+std::string GenerateRegisterLog(size_t lines)
+{
+	std::string log;
+	for (size_t i = 0; i < lines; ++i)
+	{
+		if (i % 3 == 2)
+			log += "2025-01-01 12:00:00.001 LOGIN UserName:Sherry\r\n";
+		else
+			log += "2025-01-01 12:00:00.001 REGISTER Name:User" + std::to_string(i) + ", Age:" + std::to_string(i) + "\n";
+	}
+	return log;
+}
+
+void SplitChunksTest()
+{
+	const std::string log = GenerateRegisterLog(100);
+
+	std::vector<StringView> chunks = SplitChunks(log, 7);
+	CHECK(chunks.size(), == , 7u);
+
+	size_t total = 0;
+	for (const auto& chunk : chunks)
+	{
+		CHECK(chunk[chunk.size - 1], == , '\n');
+		CHECK(chunk.data, == , log.data() + total);
+		total += chunk.size;
+	}
+	CHECK(total, == , log.size());
+
+	// more chunks than lines
+	CHECK(SplitChunks("a\nb", 5).size(), == , 2u);
+	CHECK(SplitChunks("", 5).size(), == , 0u);
+}
+
+void FileExtractorOrdered()
+{
+	const std::string log = GenerateRegisterLog(1000);
+	std::vector<Token> tokens = TokenizeFmtString("REGISTER Name:{}, Age:{}");
+
+	for (size_t threads = 1; threads <= 4; ++threads)
+	{
+		FileExtractor engine(tokens, threads);
+		std::vector<RegisterRow> rows;
+		FileExtractStats stats = engine.Run(log, ExtractRegister, rows);
+
+		CHECK(stats.lines, == , 1000u);
+		CHECK(stats.matched, == , 667u);
+		CHECK(rows.size(), == , 667u);
+		bool ordered = true;
+		for (size_t i = 1; i < rows.size(); ++i)
+			ordered = ordered && rows[i - 1].age < rows[i].age;
+		CHECK(ordered, == , true);
+		CHECK(rows[1].name.ToString(), == , "User1");
+	}
+
+	FileExtractor engine(tokens, 3);
+	std::vector<RegisterRow> rows;
+	engine.Run(log, ExtractRegister, rows, MergeOrder::Unordered);
+	CHECK(rows.size(), == , 667u);
+	long long sum = 0;
+	for (const auto& row : rows)
+		sum += row.age;
+	long long expected = 0;
+	for (int i = 0; i < 1000; ++i)
+		expected += (i % 3 == 2) ? 0 : i;
+	CHECK(sum, == , expected);
+
+	// an exception of a worker reaches the caller
+	for (size_t threads = 1; threads <= 4; threads += 3)
+	{
+		FileExtractor throwing(tokens, threads);
+		std::vector<RegisterRow> failed;
+		bool thrown = false;
+		try
+		{
+			throwing.Run(log, [](StringView line, const std::vector<Token>& tokens, RegisterRow& row)
+			{
+				bool matched = ExtractRegister(line, tokens, row);
+				if (matched && row.age == 501)
+					throw std::runtime_error("row 501");
+				return matched;
+			}, failed);
+		}
+		catch (const std::runtime_error& e)
+		{
+			thrown = std::string(e.what()) == "row 501";
+		}
+		CHECK(thrown, == , true);
+		CHECK(failed.size(), == , 0u);
+	}
+}
+
+void MappedFileTest()
+{
+	const char* path = "values_mapped_file_test.log";
+	const std::string log = GenerateRegisterLog(10);
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << log;
+	}
+
+	{
+		MappedFile file;
+		CHECK(file.Open(path), == , true);
+		CHECK(file.View() == StringView(log), == , true);
+	}
+	std::remove(path);
+
+	MappedFile missing;
+	CHECK(missing.Open(path), == , false);
+	CHECK(missing.View().empty(), == , true);
+}
+
+// Gives its data once, then fails like a device which goes away
+class FailingStreamBuf : public std::streambuf
+{
+public:
+	explicit FailingStreamBuf(const std::string& data)
+		: m_data(data)
+		, m_served(false)
+	{
+	}
+
+protected:
+	int_type underflow() override
+	{
+		if (m_served)
+			throw std::runtime_error("read failed");
+		m_served = true;
+		setg(&m_data[0], &m_data[0], &m_data[0] + m_data.size());
+		return traits_type::to_int_type(m_data[0]);
+	}
+
+private:
+	std::string m_data;
+	bool m_served;
+};
+
+void LineReaderBlocks()
+{
+	std::string log = GenerateRegisterLog(50);
+	log += std::string(100, 'x') + "\nlast line without newline";
+
+	std::vector<std::string> expected;
+	ForEachLine(log, [&](StringView line) { expected.push_back(line.ToString()); });
+
+	// blocks smaller than the lines
+	for (size_t blockSize = 1; blockSize <= 64; blockSize *= 4)
+	{
+		std::istringstream in(log);
+		LineReader reader(blockSize);
+		std::vector<std::string> lines;
+		size_t count = reader.Read(in, [&](StringView line) { lines.push_back(line.ToString()); });
+
+		CHECK(count, == , expected.size());
+		CHECK(lines == expected, == , true);
+		// the block plus the longest line
+		CHECK(reader.Capacity() <= blockSize + 100, == , true);
+		CHECK(reader.Failed(), == , false);
+	}
+
+#ifdef VALUES_HAS_MMAP
+	// a read error is not the end of the stream
+	LineReader reader;
+	size_t count = reader.Read(-1, [](StringView) {});
+	CHECK(count, == , 0u);
+	CHECK(reader.Failed(), == , true);
+	CHECK(reader.Error(), == , EBADF);
+
+	std::istringstream in(log);
+	reader.Read(in, [](StringView) {});
+	CHECK(reader.Failed(), == , false);
+#endif
+
+	// a stream which fails in the middle: the lines read before are handed
+	// out, the line it cuts is not
+	FailingStreamBuf failing("line 1\nline 2\ncut");
+	std::istream stream(&failing);
+	LineReader streamReader(4);
+	std::vector<std::string> lines;
+	CHECK(streamReader.Read(stream, [&](StringView line) { lines.push_back(line.ToString()); }), == , 2u);
+	CHECK(lines.size() == 2 && lines[1] == "line 2", == , true);
+	CHECK(streamReader.Failed(), == , true);
+	CHECK(streamReader.Error(), == , EIO);
+}
+
+void StreamExtractorTest()
+{
+	std::istringstream in(GenerateRegisterLog(30));
+
+	StreamExtractor stream(TokenizeFmtString("REGISTER Name:{}, Age:{}"), 16);
+
+	StringView name;
+	int age = 0;
+	int sum = 0;
+	std::string last;
+	size_t matched = stream.Read(in, [&](StringView)
+	{
+		sum += age;
+		last = name.ToString();
+	}, name, age);
+
+	CHECK(matched, == , 20u);
+	CHECK(stream.Lines(), == , 30u);
+	CHECK(last, == , "User28");
+	int expected = 0;
+	for (int i = 0; i < 30; ++i)
+		expected += (i % 3 == 2) ? 0 : i;
+	CHECK(sum, == , expected);
+
+#ifdef VALUES_HAS_MMAP
+	// the same from a file descriptor
+	const char* path = "values_stream_test.log";
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << GenerateRegisterLog(30);
+	}
+	int fd = open(path, O_RDONLY);
+	CHECK(stream.Read(fd, [](StringView) {}, name, age), == , 20u);
+	close(fd);
+	std::remove(path);
+#endif
+}
+
+void TryExtractTest()
+{
+	std::vector<Token> tokens = TokenizeFmtString("REGISTER Name:{}, Age:{}, ID:{h}");
+
+	std::string name = "unchanged";
+	int age = -1;
+	unsigned int id = 7;
+
+	// delimiter missing: nothing is written
+	CHECK(TryExtract("REGISTER Name:Sherry, Age:20", tokens, name, age, id), == , false);
+	CHECK(name, == , "unchanged");
+	CHECK(age, == , -1);
+
+	// the last value cannot be converted: the first ones are not written either
+	CHECK(TryExtract("REGISTER Name:Sherry, Age:20, ID:zz", tokens, name, age, id), == , false);
+	CHECK(name, == , "unchanged");
+	CHECK(age, == , -1);
+	CHECK(id, == , 7u);
+
+	CHECK(TryExtract("2025-01-01 REGISTER Name:Sherry, Age:20, ID:30AB", tokens, name, age, id), == , true);
+	CHECK(name, == , "Sherry");
+	CHECK(age, == , 20);
+	CHECK(id, == , 0x30ABu);
+
+	CHECK(TryExtract("LOGIN UserName:Sherry", "LOGIN UserName:{}", name), == , true);
+	CHECK(name, == , "Sherry");
+	CHECK(TryExtract("LOGIN UserName:Sherry", "LOGIN UserName:{}", name, age), == , false);
+}
+
+void CompiledFormatTest()
+{
+	CompiledFormat format("LOGIN UserName:{}, Age:{x}, CustomerID:{h}");
+	CHECK(format.Empty(), == , false);
+	CHECK(format.Args(), == , 2u);
+	CHECK(format.Fields(), == , 3u);
+	CHECK(format.ArgType(0) == TokenType::Matter, == , true);
+	CHECK(format.ArgType(1) == TokenType::Hex, == , true);
+	CHECK(format.Literal(0), == , StringView("LOGIN UserName:"));
+	CHECK(format.Literal(3), == , StringView(""));
+	CHECK(format.AnchoredStart(), == , false);
+	CHECK(format.AnchoredEnd(), == , true);
+
+	const std::string input = "2025-01-01 LOGIN UserName:Sherry Williams, Age:20, CustomerID:30AB";
+	CHECK(format.Match(input), == , true);
+	CHECK(format.Match("LOGIN UserName:Sherry Williams, CustomerID:30AB"), == , false);
+
+	std::string name;
+	int id = 0;
+	CHECK((bool)format.Extract(input, name, id), == , true);
+	CHECK(name, == , "Sherry Williams");
+	CHECK(id, == , 0x30AB);
+	CHECK(format.TryExtract(input, name, id), == , true);
+	CHECK(format.Extract(input, name).error == ExtractError::ArgCountMismatch, == , true);
+
+	// same results as the tokens it is converted from
+	const char* inputs[] = { "Name:, Age:1", "Name:a, Age:, Age:2", "Age:3", "Name:b, Age:x", "Name:, Age:" };
+	std::vector<Token> tokens = TokenizeFmtString("Name:{}, Age:{}");
+	CompiledFormat converted = tokens;
+	CHECK(converted.AnchoredStart(), == , false);
+	for (const char* line : inputs)
+	{
+		std::string name1, name2;
+		int age1 = 0, age2 = 0;
+		ExtractResult result1 = ValuesExtractChecked(line, tokens, name1, age1);
+		ExtractResult result2 = converted.Extract(line, name2, age2);
+		CHECK(result1.error == result2.error, == , true);
+		CHECK(result1.token, == , result2.token);
+		CHECK(result1.offset, == , result2.offset);
+		CHECK(name1, == , name2);
+		CHECK(age1, == , age2);
+		CHECK(converted.Match(line), == , detail::MatchFields(line, tokens, nullptr));
+	}
+
+	CHECK(CompiledFormat("{}: {}").AnchoredStart(), == , true);
+	CHECK(CompiledFormat("no specifier").Empty(), == , true);
+}
+
+void FormatCacheTest()
+{
+	FormatCache cache(4);
+	const CompiledFormat* format = cache.Get("REGISTER Name:{}, Age:{}");
+	CHECK(format != nullptr, == , true);
+	CHECK(format->Args(), == , 2u);
+
+	// looked up by content, not by pointer
+	std::string fmt = "REGISTER Name:{}, Age:{}";
+	CHECK(cache.Get(fmt.c_str()) == format, == , true);
+	CHECK(cache.Get("LOGIN UserName:{}") != format, == , true);
+
+	FormatCacheStats stats = cache.Stats();
+	CHECK(stats.hits, == , 1u);
+	CHECK(stats.misses, == , 2u);
+	CHECK(stats.size, == , 2u);
+	CHECK(stats.capacity, == , 4u);
+
+	// once full, the formats are not cached
+	cache.Get("A:{}");
+	cache.Get("B:{}");
+	CHECK(cache.Get("C:{}") == nullptr, == , true);
+	CHECK(cache.Stats().size, == , 4u);
+
+	FormatCache shared;
+	std::atomic<int> failed(0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&shared, &failed]()
+		{
+			const char* fmts[] = { "ID:{}", "Name:{}, Age:{}", "X:{}, Y:{}, Z:{}" };
+			for (int i = 0; i < 1000; ++i)
+			{
+				const CompiledFormat* curr = shared.Get(fmts[i % 3]);
+				if (curr == nullptr || curr->Args() != static_cast<size_t>(i % 3 + 1))
+					++failed;
+			}
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+	CHECK(failed.load(), == , 0);
+	CHECK(shared.Stats().size, == , 3u);
+	CHECK(shared.Stats().hits + shared.Stats().misses, == , 4000u);
+
+	// the fmt overloads go through the global cache once it is enabled
+	EnableFormatCache();
+	std::string name;
+	int age = 0;
+	CHECK((bool)ValuesExtractChecked("REGISTER Name:Sherry, Age:20", "REGISTER Name:{}, Age:{}", name, age), == , true);
+	ValuesExtract("REGISTER Name:John, Age:30", "REGISTER Name:{}, Age:{}", name, age);
+	CHECK(name, == , "John");
+	CHECK(age, == , 30);
+	CHECK(TryExtract("REGISTER Name:Sherry", "REGISTER Name:{}, Age:{}", name, age), == , false);
+	CHECK(GlobalFormatCache().Stats().hits >= 2u, == , true);
+	EnableFormatCache(false);
+}
+
+void AnchoredFormats()
+{
+	const std::string input = "2025-01-01 12:00:00.001 REGISTER Name:Sherry, Age:20";
+	std::string name;
+	int age = 0;
+
+	// the literal has to be at offset 24, it is not searched for
+	std::vector<Token> tokens = TokenizeFmtString("{@24}REGISTER Name:{}, Age:{}");
+	CHECK(tokens.size(), == , 2u);
+	CHECK(tokens[0].prefix, == , "REGISTER Name:");
+	CHECK(tokens[0].prefixAnchor.kind == detail::AnchorKind::Offset, == , true);
+	CHECK(tokens[0].prefixAnchor.offset, == , 24u);
+	CHECK((bool)ValuesExtractChecked(input, tokens, name, age), == , true);
+	CHECK(name, == , "Sherry");
+	CHECK(age, == , 20);
+	CHECK(ValuesExtractChecked("2025-01-01 REGISTER Name:Sherry, Age:20", tokens, name, age).error == ExtractError::PrefixNotFound, == , true);
+	CHECK(IsInputMatchedTokens(input, tokens), == , true);
+	CHECK(IsInputMatchedTokens(" " + input, tokens), == , false);
+
+	// {^} is the same as {@0}
+	CHECK(IsInputMatchedFmt(input, "{^}REGISTER Name:{}, Age:{}"), == , false);
+	CHECK(IsInputMatchedFmt(input, "{^}2025-{}REGISTER Name:{}, Age:{}"), == , true);
+
+	// {$}: the last literal ends the input
+	CHECK(TryExtract("Name:Sherry, Age:20 years", "Name:{}, Age:{} years{$}", name, age), == , true);
+	CHECK(TryExtract("Name:Sherry, Age:20 years old", "Name:{}, Age:{} years{$}", name, age), == , false);
+	CHECK(TryExtract("Name:John, Age:30.", "Name:{}, Age:{}.{$}", name, age), == , true);
+	CHECK(name, == , "John");
+	CHECK(age, == , 30);
+
+	// fixed offsets tell where side by side fields end
+	CompiledFormat format("{^}{}{@4}{}-{}");
+	CHECK(format.Empty(), == , false);
+	CHECK(format.AnchoredStart(), == , true);
+	int year = 0, month = 0, day = 0;
+	CHECK((bool)format.Extract("202501-31", year, month, day), == , true);
+	CHECK(year, == , 2025);
+	CHECK(month, == , 1);
+	CHECK(day, == , 31);
+	CHECK(format.Match("20251-31"), == , true);
+	CHECK(format.Match("202"), == , false);
+
+	// {^} only starts the fmt, {@N} a literal and {$} only ends the fmt
+	CHECK(TokenizeFmtString("Name:{}{^}, Age:{}").empty(), == , true);
+	CHECK(TokenizeFmtString("Name:{}, Age:{@3}{}").empty(), == , true);
+	CHECK(TokenizeFmtString("Name:{}{$}, Age:{}").empty(), == , true);
+	CHECK(TokenizeFmtString("{^}{@2}Name:{}").empty(), == , true);
+
+	// an offset which overflows (2^64 + 1 would wrap to 1) is not an anchor
+	// but literal text
+	tokens = TokenizeFmtString("{@18446744073709551617}x{}");
+	CHECK(tokens.size(), == , 1u);
+	CHECK(tokens[0].prefix, == , "{@18446744073709551617}x");
+	CHECK(tokens[0].prefixAnchor.Anchored(), == , false);
+	CHECK(TryExtract("ax5", tokens, age), == , false);
+
+#ifdef VALUES_HAS_CONSTEXPR14
+	CHECK(ValuesExtract(input, VALUES_FMT("{@24}REGISTER Name:{}, Age:{}{$}"), name, age), == , true);
+	CHECK(name, == , "Sherry");
+	CHECK(ValuesExtract(input + " years", VALUES_FMT("{@24}REGISTER Name:{}, Age:{} years{$}"), name, age), == , true);
+	CHECK(ValuesExtract(input + " years old", VALUES_FMT("{@24}REGISTER Name:{}, Age:{} years{$}"), name, age), == , false);
+	CHECK(ValuesExtract(input, VALUES_FMT("{^}REGISTER Name:{}, Age:{}"), name, age), == , false);
+	CHECK(ValuesExtract("ax5", VALUES_FMT("{@18446744073709551617}x{}"), age), == , false);
+#endif
+}
+
+void FixedWidthFields()
+{
+	std::vector<Token> tokens = TokenizeFmtString("ID:{8h}{4}{2x}{2t}, Name:{}");
+	CHECK(tokens.size(), == , 5u);
+	CHECK(tokens[0].width, == , 8u);
+	CHECK(tokens[0].type == TokenType::Hex, == , true);
+	CHECK(tokens[1].width, == , 4u);
+	CHECK(tokens[1].type == TokenType::Matter, == , true);
+	CHECK(tokens[2].type == TokenType::None, == , true);
+	CHECK(tokens[3].type == TokenType::Trim, == , true);
+	CHECK(tokens[4].width, == , 0u);
+
+	unsigned int id = 0;
+	int year = 0;
+	std::string day;
+	std::string name;
+	CHECK((bool)ValuesExtractChecked("ID:0000ABCD202501 7, Name:Sherry", tokens, id, year, day, name), == , true);
+	CHECK(id, == , 0xABCDu);
+	CHECK(year, == , 2025);
+	CHECK(day, == , "7");
+	CHECK(name, == , "Sherry");
+
+	// the postfix has to follow the field, which cannot run past the input
+	ExtractResult result = ValuesExtractChecked("ID:0000ABCD202501 7 Name:Sherry", tokens, id, year, day, name);
+	CHECK(result.error == ExtractError::PostfixNotFound, == , true);
+	CHECK(result.token, == , 3);
+	CHECK(ValuesExtractChecked("ID:0000ABCD2025", tokens, id, year, day, name).error == ExtractError::PostfixNotFound, == , true);
+
+	// the rest of the input after the last fixed-width field is ignored
+	int month = 0;
+	CHECK(TryExtract("202501-31", "{4}{2}", year, month), == , true);
+	CHECK(year, == , 2025);
+	CHECK(month, == , 1);
+
+	CompiledFormat format("{4}{2}{$}");
+	CHECK(format.Match("202501"), == , true);
+	CHECK(format.Match("202501-31"), == , false);
+
+	// {0} is not a specifier and a field without width still cannot be
+	// followed by another one
+	CHECK(TokenizeFmtString("A:{0}").empty(), == , true);
+	CHECK(TokenizeFmtString("{}{2}").empty(), == , true);
+	// nor is a width which overflows (2^64 + 2 would wrap to 2)
+	CHECK(TokenizeFmtString("A:{18446744073709551618}").empty(), == , true);
+	tokens = TokenizeFmtString("{18446744073709551618h}{}");
+	CHECK(tokens.size(), == , 1u);
+	CHECK(tokens[0].prefix, == , "{18446744073709551618h}");
+
+#ifdef VALUES_HAS_CONSTEXPR14
+	CHECK(ValuesExtract("20250131", VALUES_FMT("{4}{2}{2}"), year, month, id), == , true);
+	CHECK(id, == , 31u);
+#endif
+}
+
+void CharClassFields()
+{
+	std::vector<Token> tokens = TokenizeFmtString("Age:{d} Name:{w} {a}");
+	CHECK(tokens.size(), == , 3u);
+	CHECK(tokens[0].type == TokenType::Digits, == , true);
+	CHECK(tokens[1].type == TokenType::Word, == , true);
+	CHECK(tokens[2].type == TokenType::Alnum, == , true);
+
+	int age = 0;
+	std::string name;
+	std::string code;
+	// the space postfix is not searched for: each field ends at the first
+	// character out of its class, where the postfix has to be
+	CHECK((bool)ValuesExtractChecked("Age:20 Name:Sherry-W Id42;", tokens, age, name, code), == , true);
+	CHECK(age, == , 20);
+	CHECK(name, == , "Sherry-W");
+	CHECK(code, == , "Id42");
+
+	ExtractResult result = ValuesExtractChecked("Age:20y Name:Sherry Id42", tokens, age, name, code);
+	CHECK(result.error == ExtractError::PostfixNotFound, == , true);
+	CHECK(result.token, == , 0);
+	CHECK(result.offset, == , 4u);
+
+	// no digit: the field is empty
+	CHECK(ValuesExtractChecked("Age: Name:Sherry Id42", tokens, age, name, code).error == ExtractError::EmptyValue, == , true);
+
+	// a field of a class can be followed by another field
+	unsigned int id = 0;
+	CHECK(TryExtract("ID:42abc", "ID:{d}{a}", id, code), == , true);
+	CHECK(id, == , 42u);
+	CHECK(code, == , "abc");
+
+	// converted like {} by DataTypeRef too
+	std::vector<DataTypeRef> results;
+	detail::AddData(results, age, name, code);
+	detail::ValuesExtractHelp("Age:31 Name:John Id7", tokens, results);
+	CHECK(age, == , 31);
+	CHECK(name, == , "John");
+
+	CompiledFormat format("{d}.{d}.{d}.{d}{$}");
+	CHECK(format.Match("192.168.0.1"), == , true);
+	CHECK(format.Match("192.168.0.1a"), == , false);
+	CHECK(format.Match("192.168.x.1"), == , false);
+
+	for (int c = 0; c < 256; ++c)
+	{
+		CHECK((detail::CharClassTable<>::classes[c] & detail::ClassDigit) != 0, == , isdigit(c) != 0);
+		CHECK((detail::CharClassTable<>::classes[c] & detail::ClassAlnum) != 0, == , c < 128 && isalnum(c) != 0);
+		CHECK((detail::CharClassTable<>::classes[c] & detail::ClassWord) != 0, == , isspace(c) == 0);
+	}
+
+#ifdef VALUES_HAS_CONSTEXPR14
+	CHECK(ValuesExtract("ID:42abc", VALUES_FMT("ID:{d}{a}"), id, code), == , true);
+	CHECK(code, == , "abc");
+#endif
+}
+
+void SearchPathological()
+{
+	// every position is a candidate for the anchor bytes, so the search
+	// falls back to the linear one
+	const std::string find = std::string(100, 'x') + ",";
+	std::string input(20000, 'x');
+	CHECK(detail::Search(input, find, detail::MakeSearcher(find), 0), == , StringView::npos);
+	input += ",";
+	CHECK(detail::Search(input, find, detail::MakeSearcher(find), 5), == , input.size() - find.size());
+	input += "xx";
+	CHECK(detail::Search(input, find, detail::MakeSearcher(find), 19800), == , input.size() - 2 - find.size());
+
+	// periodic inputs and delimiters
+	const char* finds[] = { "abab", "aab", "abaabab", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxy" };
+	const char* units[] = { "ab", "aab", "aba", "x" };
+	for (const char* curr : finds)
+	{
+		for (const char* unit : units)
+		{
+			std::string text;
+			for (int i = 0; i < 300; ++i)
+				text += unit;
+			for (size_t pos = 0; pos < 40; pos += 3)
+			{
+				CHECK(detail::Search(text, curr, detail::MakeSearcher(curr), pos), == , text.find(curr, pos));
+				CHECK(detail::SearchLinear(text, curr, pos), == , text.find(curr, pos));
+			}
+		}
+	}
+}
+
+// The documented semantics, on std::string::find: each delimiter at its
+// leftmost occurrence, the postfix after the first character of the field
+// unless it only follows the prefix directly.
+static bool ReferenceMatch(const std::string& input, const std::vector<Token>& tokens, std::vector<std::string>& fields)
+{
+	size_t pos = 0;
+	for (const auto& token : tokens)
+	{
+		size_t start = pos;
+		if (token.prefix.empty() == false)
+		{
+			start = input.find(token.prefix, pos);
+			if (start == std::string::npos)
+				return false;
+			start += token.prefix.size();
+		}
+
+		size_t end = input.size();
+		if (token.postfix.empty() == false)
+		{
+			end = input.find(token.postfix, start + 1);
+			if (end == std::string::npos)
+			{
+				if (input.compare(start, token.postfix.size(), token.postfix) != 0)
+					return false;
+				end = start;
+			}
+		}
+		fields.push_back(input.substr(start, end - start));
+		pos = end;
+	}
+	return true;
+}
+
+void MatcherConsistency()
+{
+	const char alphabet[] = "ab:";
+	uint64_t seed = 2463534242ULL;
+	auto random = [&seed]()
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return (size_t)seed;
+	};
+	auto literal = [&](size_t min)
+	{
+		std::string text(min + random() % 3, ' ');
+		for (auto& ch : text)
+			ch = alphabet[random() % 3];
+		return text;
+	};
+
+	for (int i = 0; i < 3000; ++i)
+	{
+		std::string fmt = literal(0);
+		const size_t fields = 1 + random() % 3;
+		for (size_t f = 0; f < fields; ++f)
+			fmt += "{}" + literal(f + 1 < fields ? 1 : 0);
+		std::vector<Token> tokens = TokenizeFmtString(fmt);
+		CompiledFormat format(tokens);
+		FormatSet set;
+		set.Add(tokens);
+		set.Build();
+
+		for (int j = 0; j < 10; ++j)
+		{
+			std::string input(random() % 16, ' ');
+			for (auto& ch : input)
+				ch = "ab:x"[random() % 4];
+
+			std::vector<std::string> expected;
+			const bool matched = ReferenceMatch(input, tokens, expected);
+			std::vector<StringView> found;
+			CHECK(detail::MatchFields(input, tokens, &found), == , matched);
+			CHECK(IsInputMatchedTokens(input, tokens), == , matched);
+			CHECK(format.Match(input), == , matched);
+			CHECK(set.Match(input) == 0, == , matched);
+			if (matched)
+			{
+				CHECK(found.size(), == , expected.size());
+				for (size_t f = 0; f < found.size() && f < expected.size(); ++f)
+					CHECK(found[f].ToString(), == , expected[f]);
+			}
+		}
+	}
+}
+
+void ArenaStrings()
+{
+	StringArena arena(64);
+	StringView copy = arena.Copy("Sherry");
+	CHECK(copy, == , StringView("Sherry"));
+	CHECK(arena.BytesUsed(), == , 6u);
+	CHECK(arena.Blocks(), == , 1u);
+
+	// a string larger than a block gets a block of its own
+	std::string large(100, 'x');
+	CHECK(arena.Copy(large), == , StringView(large));
+	CHECK(arena.Blocks(), == , 2u);
+	CHECK(arena.BytesReserved() >= 164u, == , true);
+
+	void* aligned = arena.Allocate(8, 8);
+	CHECK(reinterpret_cast<uintptr_t>(aligned) % 8, == , 0u);
+
+	// the blocks are kept by Reset and freed by Clear
+	const size_t reserved = arena.BytesReserved();
+	arena.Reset();
+	CHECK(arena.BytesUsed(), == , 0u);
+	CHECK(arena.Copy(large), == , StringView(large));
+	CHECK(arena.BytesReserved(), == , reserved);
+	arena.Clear();
+	CHECK(arena.Blocks(), == , 0u);
+	CHECK(arena.BytesReserved(), == , 0u);
+
+	const std::string input = "REGISTER Name: Sherry Williams , Age:20";
+	ArenaString name(arena);
+	int age = 0;
+	CHECK((bool)ValuesExtractChecked(input, "REGISTER Name:{t}, Age:{}", name, age), == , true);
+	CHECK(name.View(), == , StringView("Sherry Williams"));
+	CHECK(name.data() >= input.data() && name.data() < input.data() + input.size(), == , false);
+	CHECK(age, == , 20);
+
+	ArenaString other(arena);
+	CHECK(TryExtract("Name:John, Age:30", "Name:{}, Age:{}", other, age), == , true);
+	CHECK(other.ToString(), == , "John");
+	CHECK(name.View(), == , StringView("Sherry Williams"));
+
+	CompiledFormat format("Name:{}, Age:{}");
+	CHECK((bool)format.Extract("Name:Jane, Age:40", other, age), == , true);
+	CHECK(other.ToString(), == , "Jane");
+
+	std::vector<DataTypeRef> results;
+	detail::AddData(results, other);
+	detail::ValuesExtractHelp("Name:Anna", TokenizeFmtString("Name:{}"), results);
+	CHECK(other.ToString(), == , "Anna");
+
+	// a string whose memory comes from the arena
+	typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> ArenaStdString;
+	arena.Clear();
+	ArenaStdString longName{ ArenaAllocator<char>(arena) };
+	CHECK((bool)ValuesExtractChecked("Name:Sherry Williams-Richardson, Age:20", "Name:{}, Age:{}", longName, age), == , true);
+	CHECK(longName == "Sherry Williams-Richardson", == , true);
+	CHECK(arena.BytesUsed() > 0u, == , true);
+	CHECK(TryExtract("Name:  Jo  ", "Name:{t}", longName), == , true);
+	CHECK(longName == "Jo", == , true);
+}
+
+void FormatSetMatch()
+{
+	FormatSet formats;
+	size_t login = formats.Add("LOGIN UserName:{}, CustomerID:{h}");
+	size_t reg = formats.Add("REGISTER Name:{}, Age:{}");
+	size_t logout = formats.Add("LOGOUT UserName:{}");
+	formats.Build();
+
+	CHECK(formats.Size(), == , 3u);
+
+	const std::string input = "2025-01-01 12:00:00.001 REGISTER Name:Sherry, Age:20";
+
+	FormatMatch match;
+	bool matched = formats.Match(input, match);
+	CHECK(matched, == , true);
+	CHECK(match.id, == , reg);
+	CHECK(match.fields.size(), == , 2u);
+
+	std::string name;
+	int age = 0;
+	ExtractResult result = formats.Convert(match, name, age);
+	CHECK((bool)result, == , true);
+	CHECK(name, == , "Sherry");
+	CHECK(age, == , 20);
+
+	CHECK(formats.Match("LOGIN UserName:Sherry Williams, CustomerID:30AB"), == , login);
+	CHECK(formats.Match("LOGOUT UserName:Sherry"), == , logout);
+
+	size_t none = FormatSet::npos;
+	CHECK(formats.Match("LOGOUT Name:Sherry"), == , none);
+	CHECK(formats.Match("LOGOUT Name:Sherry", match), == , false);
+	CHECK(match.fields.empty(), == , true);
+}
+
+void FormatSetOrder()
+{
+	FormatSet formats;
+	size_t first = formats.Add("Name:{}, Age:{}");
+	formats.Add("REGISTER Name:{}, Age:{}");
+	size_t anyInput = formats.Add("{} {}");
+	size_t invalid = formats.Add("{}{}");
+	size_t none = FormatSet::npos;
+	CHECK(invalid, == , none);
+
+	// the first format added which matches wins, built or not
+	for (int built = 0; built < 2; ++built)
+	{
+		if (built)
+			formats.Build();
+
+		CHECK(formats.Match("REGISTER Name:Sherry, Age:20"), == , first);
+		CHECK(formats.Match("Hello World"), == , anyInput);
+		CHECK(formats.Match("HelloWorld"), == , none);
+	}
+}
+
+void FormatSetCatalog()
+{
+	const char* words[] = { "LOGIN", "LOGOUT", "REGISTER", "UPDATE", "DELETE", "Name", "User", "ID", "Age", "Status" };
+
+	FormatSet formats;
+	std::vector<std::string> fmts;
+	uint64_t seed = 88172645463325252ULL;
+	auto random = [&seed]()
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 7;
+		seed ^= seed << 17;
+		return (size_t)seed;
+	};
+	for (int i = 0; i < 300; ++i)
+	{
+		std::string fmt = std::string(words[random() % 5]) + " " + words[5 + random() % 5] + std::to_string(random() % 50) + ":{}";
+		if (random() % 2)
+			fmt += std::string(", ") + words[5 + random() % 5] + ":{}";
+		fmts.push_back(fmt);
+		formats.Add(fmt.c_str());
+	}
+	formats.Build();
+
+	// a smaller set matched in turn on the same thread
+	FormatSet few;
+	for (size_t id = 0; id < 40; ++id)
+		few.Add(fmts[id].c_str());
+	few.Build();
+
+	auto expect = [](const FormatSet& set, const std::string& input)
+	{
+		for (size_t id = 0; id < set.Size(); ++id)
+		{
+			if (detail::MatchFields(input, set.Tokens(id), nullptr))
+				return id;
+		}
+		return FormatSet::npos;
+	};
+
+	// the automaton must agree with trying the formats in order, also when
+	// the literals are found more than once
+	for (int i = 0; i < 1000; ++i)
+	{
+		std::string input = std::string(words[random() % 5]) + " " + words[5 + random() % 5] + std::to_string(random() % 50) + ":1, " + words[5 + random() % 5] + ":2";
+		std::string twice = input + ", " + input;
+
+		CHECK(formats.Match(input), == , expect(formats, input));
+		CHECK(few.Match(input), == , expect(few, input));
+		CHECK(formats.Match(twice), == , expect(formats, twice));
+		CHECK(few.Match(twice), == , expect(few, twice));
+	}
+}
+
+#ifdef VALUES_ENABLE_STATS
+void FormatStatsCounters()
+{
+	ResetFormatStats();
+
+	auto find = [](const char* fmt)
+	{
+		for (const FormatStats& stats : CollectFormatStats())
+		{
+			if (stats.fmt == fmt)
+				return stats;
+		}
+		return FormatStats();
+	};
+
+	std::vector<Token> tokens = TokenizeFmtString("id={}, name={};");
+	int id = 0;
+	std::string name;
+	CHECK(TryExtract("id=5, name=abc;", tokens, id, name), == , true);
+	CHECK(TryExtract("id=x, name=abc;", tokens, id, name), == , false);
+	CHECK(TryExtract("id=5, name=abc", tokens, id, name), == , false);
+	CHECK(IsInputMatchedTokens("nothing", tokens), == , false);
+
+	// the same fmt compiled shares the counters of its tokens
+	CompiledFormat format("id={}, name={};");
+	CHECK(format.Extract("id=7, name=xyz;", id, name).error == ExtractError::None, == , true);
+
+	FormatStats stats = find("id={}, name={};");
+	CHECK(stats.calls, == , 5u);
+	CHECK(stats.matches, == , 3u);
+	CHECK(stats.misses, == , 2u);
+	CHECK(stats.missesByToken.size(), == , 2u);
+	CHECK(stats.missesByToken[0], == , 1u);
+	CHECK(stats.missesByToken[1], == , 1u);
+	CHECK(stats.conversionErrors, == , 1u);
+	CHECK(stats.bytesScanned, == , 15u * 3 + 14 + 7);
+
+	// the counters of the threads which exited are kept
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([]()
+		{
+			CompiledFormat format("{}:{}");
+			int a = 0, b = 0;
+			for (int i = 0; i < 1000; ++i)
+				format.TryExtract("1:2", a, b);
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+	CHECK(find("{}:{}").calls, == , 4000u);
+	CHECK(find("{}:{}").matches, == , 4000u);
+
+	std::vector<DataTypeRef> results;
+	float value = 0;
+	results.push_back(DataTypeRef(value));
+	detail::ValuesExtractHelp("v=bad", TokenizeFmtString("v={}"), results);
+	CHECK(find("v={}").conversionErrors, == , 1u);
+
+	// the argument of a field is part of the fmt
+	CHECK(IsInputMatchedTokens("at 12:30", TokenizeFmtString("at {ts:%H:%M}")), == , true);
+	CHECK(find("at {ts:%H:%M}").matches, == , 1u);
+
+	ResetFormatStats();
+	CHECK(find("id={}, name={};").calls, == , 0u);
+}
+#endif
+
+#ifdef VALUES_HAS_CONSTEXPR14
+void CompileTimeFormat()
+{
+	const std::string input = "2025-01-01 12:00:00.001 REGISTER Name:Sherry, Age:20";
+
+	std::string name;
+
+	int age = 0;
+
+	bool isMatched = ValuesExtract(input, VALUES_FMT("REGISTER Name:{}, Age:{}"), name, age);
+
+	CHECK(isMatched, == , true);
+
+	CHECK(name, == , "Sherry");
+
+	CHECK(age, == , 20);
+}
+
+void CompileTimeFormatMixed()
+{
+	const std::string input = "CustID:234, Name:  Sherry William  , Binary:0xA";
+
+	StringView name;
+
+	int hex = 0;
+
+	bool isMatched = ValuesExtract(input, VALUES_FMT("CustID:{x}, Name:{t}, Binary:{h}"), name, hex);
+
+	CHECK(isMatched, == , true);
+
+	CHECK(name, == , "Sherry William");
+
+	CHECK(hex, == , 10);
+
+	isMatched = ValuesExtract("CustID:234, Binary:0xA", VALUES_FMT("CustID:{x}, Name:{t}, Binary:{h}"), name, hex);
+
+	CHECK(isMatched, == , false);
+}
+#endif
+
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+void CompileTimeFixedString()
+{
+	const std::string input = "REGISTER Name:Sherry, Age:20";
+
+	std::string name;
+
+	int age = 0;
+
+	bool isMatched = ValuesExtract<"REGISTER Name:{}, Age:{}">(input, name, age);
+
+	CHECK(isMatched, == , true);
+
+	CHECK(name, == , "Sherry");
+
+	CHECK(age, == , 20);
+}
+#endif
+
 int main()
 {
 	UnitTest::Add("SingleVariable", "Integer", Integer);
@@ -554,6 +2216,7 @@ int main()
 	UnitTest::Add("SingleVariable", "StringWithTimestamp", StringWithTimestamp);
 	UnitTest::Add("SingleVariable", "StringWithSuffix", StringWithSuffix);
 	UnitTest::Add("SingleVariable", "TrimString", TrimString);
+	UnitTest::Add("SingleVariable", "TrimCharSet", TrimCharSet);
 	UnitTest::Add("SingleVariable", "HexString", HexString);
 	UnitTest::Add("SingleVariable", "HexString2", HexString2);
 	UnitTest::Add("SingleVariable", "HexString3", HexString3);
@@ -578,6 +2241,58 @@ int main()
 	UnitTest::Add("Tokens", "ThreeVariableTokenized", ThreeVariableTokenized);
 	UnitTest::Add("Tokens", "EmptyTokenized", EmptyTokenized);
 	UnitTest::Add("Tokens", "LastEmptyTokenized", LastEmptyTokenized);
+	UnitTest::Add("Tokens", "StringViewTest", StringViewTest);
+	UnitTest::Add("Tokens", "TokenizeMixedSpecifiers", TokenizeMixedSpecifiers);
+	UnitTest::Add("Tokens", "TokenizeSideBySide", TokenizeSideBySide);
+	UnitTest::Add("Tokens", "DataTypeRefTokenized", DataTypeRefTokenized);
+
+	UnitTest::Add("Conversion", "IntegerKernels", IntegerKernels);
+	UnitTest::Add("Conversion", "FloatKernels", FloatKernels);
+	UnitTest::Add("Conversion", "Utf8Strings", Utf8Strings);
+	UnitTest::Add("Conversion", "Timestamps", Timestamps);
+	UnitTest::Add("Conversion", "Addresses", Addresses);
+	UnitTest::Add("Conversion", "FieldPaths", FieldPaths);
+
+	UnitTest::Add("Checked", "CheckedSuccess", CheckedSuccess);
+	UnitTest::Add("Checked", "CheckedDelimiterNotFound", CheckedDelimiterNotFound);
+	UnitTest::Add("Checked", "CheckedConversionErrors", CheckedConversionErrors);
+	UnitTest::Add("Checked", "TryExtractTest", TryExtractTest);
+	UnitTest::Add("Checked", "CompiledFormatTest", CompiledFormatTest);
+	UnitTest::Add("Checked", "FormatCacheTest", FormatCacheTest);
+
+	UnitTest::Add("Search", "SearchMatchesFind", SearchMatchesFind);
+	UnitTest::Add("Search", "SearcherAnchors", SearcherAnchors);
+	UnitTest::Add("Search", "AnchoredFormats", AnchoredFormats);
+	UnitTest::Add("Search", "FixedWidthFields", FixedWidthFields);
+	UnitTest::Add("Search", "CharClassFields", CharClassFields);
+	UnitTest::Add("Search", "SearchPathological", SearchPathological);
+	UnitTest::Add("Search", "MatcherConsistency", MatcherConsistency);
+
+	UnitTest::Add("FormatSet", "FormatSetMatch", FormatSetMatch);
+	UnitTest::Add("FormatSet", "FormatSetOrder", FormatSetOrder);
+	UnitTest::Add("FormatSet", "FormatSetCatalog", FormatSetCatalog);
+
+	UnitTest::Add("Batch", "BatchColumns", BatchColumns);
+
+	UnitTest::Add("Arena", "ArenaStrings", ArenaStrings);
+#ifdef VALUES_ENABLE_STATS
+
+	UnitTest::Add("Stats", "FormatStatsCounters", FormatStatsCounters);
+#endif
+
+	UnitTest::Add("File", "SplitChunksTest", SplitChunksTest);
+	UnitTest::Add("File", "FileExtractorOrdered", FileExtractorOrdered);
+	UnitTest::Add("File", "MappedFileTest", MappedFileTest);
+	UnitTest::Add("File", "LineReaderBlocks", LineReaderBlocks);
+	UnitTest::Add("File", "StreamExtractorTest", StreamExtractorTest);
+
+#ifdef VALUES_HAS_CONSTEXPR14
+	UnitTest::Add("CompileTime", "CompileTimeFormat", CompileTimeFormat);
+	UnitTest::Add("CompileTime", "CompileTimeFormatMixed", CompileTimeFormatMixed);
+#endif
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+	UnitTest::Add("CompileTime", "CompileTimeFixedString", CompileTimeFixedString);
+#endif
 
 	// RunAllTests() return number of errors
 	return UnitTest::RunAllTests();
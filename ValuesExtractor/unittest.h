@@ -117,10 +117,10 @@ public:
 			errors += local_errors;
 			size_t local_count = list.second.size();
 
-			printf("[----------] %zu tests from %s (%llu ms total)\n\n", list.second.size(), list.first.c_str(), suiteTime);
+			printf("[----------] %zu tests from %s (%llu ms total)\n\n", local_count, list.first.c_str(), suiteTime);
 
 			if (File)
-				fprintf(File, "[----------] %zu tests from %s (%llu ms total)\n\n", list.second.size(), list.first.c_str(), suiteTime);
+				fprintf(File, "[----------] %zu tests from %s (%llu ms total)\n\n", local_count, list.first.c_str(), suiteTime);
 
 			totalTime += suiteTime;
 		}
@@ -12,17 +12,183 @@
 #include <algorithm>
 #include <cstdlib>
 #include <cstdint>
+#include <stdexcept>
+#include <cfloat>
+#include <type_traits>
+#include <limits>
+#include <cmath>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <array>
+
+#ifdef VALUES_ENABLE_STATS
+	#include <map>
+	#include <unordered_map>
+#endif
+
+#if defined(_MSVC_LANG)
+	#define VALUES_CPLUSPLUS _MSVC_LANG
+#else
+	#define VALUES_CPLUSPLUS __cplusplus
+#endif
+
+#if VALUES_CPLUSPLUS >= 201402L
+	#include <utility>
+	#include <tuple>
+	#define VALUES_HAS_CONSTEXPR14 1
+	#define VALUES_CONSTEXPR14 constexpr
+#else
+	#define VALUES_CONSTEXPR14 inline
+#endif
+
+#if VALUES_CPLUSPLUS >= 201703L
+	#include <string_view>
+	#include <charconv>
+	#define VALUES_HAS_STRING_VIEW 1
+	#if defined(__cpp_lib_to_chars)
+		#define VALUES_HAS_FROM_CHARS_FLOAT 1
+	#endif
+#endif
+
+// 8 digits are parsed at once from a little endian 64-bit load
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	#define VALUES_SWAR 1
+#endif
+
+// Delimiters are searched 16 (SSE2) or 32 (AVX2) positions at once unless
+// VALUES_NO_SIMD is defined
+#if !defined(VALUES_NO_SIMD)
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#include <emmintrin.h>
+		#define VALUES_SSE2 1
+	#endif
+	#if defined(__AVX2__)
+		#include <immintrin.h>
+		#define VALUES_AVX2 1
+	#endif
+	#if defined(_MSC_VER) && (defined(VALUES_SSE2) || defined(VALUES_AVX2))
+		#include <intrin.h>
+	#endif
+#endif
 
 namespace values
 {
+	// Non-owning view of a character range (pointer + length). It is used to
+	// hand the input and the extracted fields around without copying them.
+	struct StringView
+	{
+		static const size_t npos = static_cast<size_t>(-1);
+
+		StringView() : data(""), size(0) {}
+
+		StringView(const char* s, size_t len) : data(s), size(len) {}
+
+		StringView(const char* s) : data(s), size(strlen(s)) {}
+
+		StringView(const std::string& s) : data(s.data()), size(s.size()) {}
+
+#ifdef VALUES_HAS_STRING_VIEW
+		StringView(std::string_view s) : data(s.data()), size(s.size()) {}
+
+		operator std::string_view() const { return std::string_view(data, size); }
+#endif
+
+		bool empty() const { return size == 0; }
+
+		char operator[](size_t i) const { return data[i]; }
+
+		const char* begin() const { return data; }
+
+		const char* end() const { return data + size; }
+
+		StringView substr(size_t pos, size_t len = npos) const
+		{
+			if (pos > size)
+				pos = size;
+			if (len > size - pos)
+				len = size - pos;
+			return StringView(data + pos, len);
+		}
+
+		std::string ToString() const { return std::string(data, size); }
+
+		const char* data;
+		size_t size;
+	};
+
+	inline bool operator==(StringView a, StringView b)
+	{
+		return a.size == b.size && (a.size == 0 || memcmp(a.data, b.data, a.size) == 0);
+	}
+
+	inline bool operator!=(StringView a, StringView b)
+	{
+		return !(a == b);
+	}
+
+	inline std::ostream& operator<<(std::ostream& os, StringView sv)
+	{
+		return os.write(sv.data, sv.size);
+	}
+
 	enum class TokenType
 	{
 		None,
 		Hex,
 		Matter,
-		Trim
+		Trim,
+		// converted like Matter; the field ends at the first character
+		// which is not a digit, not whitespace or not alphanumeric
+		Digits,
+		Word,
+		Alnum,
+		// {ts:layout}, parsed into a time_point or into epoch nanoseconds
+		Timestamp,
+		// {ip}, {ip6} and {mac}, parsed into their bytes; the field ends at
+		// the first character which cannot be part of the address
+		Ipv4,
+		Ipv6,
+		Mac
 	};
 
+	namespace detail
+	{
+		// How a delimiter is searched for: the bytes at offset1 and offset2,
+		// the rarest ones of the delimiter, are compared first. It holds no
+		// pointer, so it stays valid when the Token is copied; a Searcher
+		// whose size is not the delimiter's is ignored.
+		struct Searcher
+		{
+			VALUES_CONSTEXPR14 Searcher() : size(0), offset1(0), offset2(0) {}
+
+			size_t size;
+			uint32_t offset1;
+			uint32_t offset2;
+		};
+
+		enum class AnchorKind : uint8_t
+		{
+			None,
+			Offset,
+			End
+		};
+
+		// Where a delimiter has to be in the input: anywhere after the
+		// previous field, at a fixed offset ({^} and {@N}) or at the end ({$})
+		struct Anchor
+		{
+			VALUES_CONSTEXPR14 Anchor() : kind(AnchorKind::None), offset(0) {}
+			VALUES_CONSTEXPR14 Anchor(AnchorKind kind_, size_t offset_) : kind(kind_), offset(offset_) {}
+
+			bool Anchored() const { return kind != AnchorKind::None; }
+
+			AnchorKind kind;
+			size_t offset;
+		};
+	}
+
 	struct Token
 	{
 		int index;
@@ -31,567 +197,4480 @@ namespace values
 		TokenType type;
 		std::string prefix;
 		std::string postfix;
+		// set by TokenizeFmtString
+		detail::Searcher prefixSearcher;
+		detail::Searcher postfixSearcher;
+		detail::Anchor prefixAnchor;
+		detail::Anchor postfixAnchor;
+		// of a fixed-width field, 0 if the postfix ends the field
+		size_t width;
+		// trimmed from a {t} field, whitespace if empty
+		std::string trimChars;
+		// of a {ts} field, DefaultTimestampLayout() if empty
+		std::string layout;
 	};
 
-	class DataTypeRef
+	enum class ExtractError : uint8_t
+	{
+		None,
+		ArgCountMismatch,
+		PrefixNotFound,
+		PostfixNotFound,
+		EmptyValue,
+		InvalidValue,
+		TrailingChars,
+		OutOfRange,
+		InvalidEncoding
+	};
+
+	inline const char* ToString(ExtractError error)
+	{
+		switch (error)
+		{
+		case ExtractError::None: return "None";
+		case ExtractError::ArgCountMismatch: return "Number of parameters and fmt token mismatched";
+		case ExtractError::PrefixNotFound: return "Prefix not found";
+		case ExtractError::PostfixNotFound: return "Postfix not found";
+		case ExtractError::EmptyValue: return "Value is a empty string";
+		case ExtractError::InvalidValue: return "Value is not a number";
+		case ExtractError::TrailingChars: return "Trailing characters after the value";
+		case ExtractError::OutOfRange: return "Value is out of range of the parameter type";
+		case ExtractError::InvalidEncoding: return "Value is not valid UTF-8";
+		}
+		return "Unknown";
+	}
+
+	// Outcome of ValuesExtractChecked: what failed, in which token of the
+	// format and at which offset of the input.
+	struct ExtractResult
+	{
+		ExtractError error;
+		// index in the tokens (including {x}) of the failed token, -1 if none
+		int32_t token;
+		size_t offset;
+
+		explicit operator bool() const { return error == ExtractError::None; }
+	};
+
+	// Bump allocator for the strings extracted from a batch of lines: they
+	// are laid one after the other in large blocks, which are released all
+	// at once by Reset or by the destructor instead of one string at a time.
+	class StringArena
 	{
 	public:
-		~DataTypeRef() {}
+		static const size_t DefaultBlockSize = 64 * 1024;
 
-		union UNIONPTR
+		explicit StringArena(size_t blockSize = DefaultBlockSize)
+			: m_blockSize(blockSize ? blockSize : 1)
+			, m_block(0)
+			, m_offset(0)
+			, m_used(0)
+			, m_reserved(0)
 		{
-			int32_t* pi;
-			uint32_t* pui;
-			int16_t* psi;
-			uint16_t* pusi;
-			int64_t* pi64;
-			uint64_t* pui64;
-			float* pf;
-			double* pd;
-			std::string* ps;
-			std::wstring* pws;
-			char* pc;
-			unsigned char* puc;
-			wchar_t* pwc;
-		};
+		}
 
-		enum DTR_TYPE
+		StringArena(const StringArena&) = delete;
+		StringArena& operator=(const StringArena&) = delete;
+
+		// The memory stays valid until Reset, Clear or the destructor
+		void* Allocate(size_t size, size_t align = 1)
 		{
-			DTR_INT,
-			DTR_UINT,
-			DTR_SHORT,
-			DTR_USHORT,
-			DTR_INT64,
-			DTR_UINT64,
-			DTR_FLOAT,
-			DTR_DOUBLE,
-			DTR_STR,
-			DTR_WSTR,
-			DTR_CHAR,
-			DTR_UCHAR,
-			DTR_WCHAR
+			if (m_block < m_blocks.size())
+			{
+				const Block& block = m_blocks[m_block];
+				const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+				const size_t offset = static_cast<size_t>(((base + m_offset + align - 1) & ~static_cast<uintptr_t>(align - 1)) - base);
+				if (offset <= block.size && size <= block.size - offset)
+				{
+					m_offset = offset + size;
+					m_used += size;
+					return block.data.get() + offset;
+				}
+			}
+			return AllocateSlow(size, align);
+		}
+
+		StringView Copy(StringView str)
+		{
+			if (str.empty())
+				return StringView();
+			char* p = static_cast<char*>(Allocate(str.size));
+			memcpy(p, str.data, str.size);
+			return StringView(p, str.size);
+		}
+
+		// Releases every string at once. The blocks are kept for the next
+		// batch, so a steady stream of batches does not allocate.
+		void Reset()
+		{
+			m_block = 0;
+			m_offset = 0;
+			m_used = 0;
+		}
+
+		// Releases every string and frees the blocks
+		void Clear()
+		{
+			m_blocks.clear();
+			m_reserved = 0;
+			Reset();
+		}
+
+		size_t BytesUsed() const { return m_used; }
+
+		size_t BytesReserved() const { return m_reserved; }
+
+		size_t Blocks() const { return m_blocks.size(); }
+
+	private:
+		// Moves to the next kept block large enough, or to a new one
+		void* AllocateSlow(size_t size, size_t align)
+		{
+			if (m_block < m_blocks.size() && m_offset != 0)
+				++m_block;
+			m_offset = 0;
+
+			const size_t need = size + align - 1;
+			for (size_t i = m_block; i < m_blocks.size(); ++i)
+			{
+				if (m_blocks[i].size >= need)
+				{
+					std::swap(m_blocks[i], m_blocks[m_block]);
+					return Allocate(size, align);
+				}
+			}
+
+			Block block;
+			block.size = std::max(m_blockSize, need);
+			block.data.reset(new char[block.size]);
+			m_reserved += block.size;
+			m_blocks.insert(m_blocks.begin() + m_block, std::move(block));
+			return Allocate(size, align);
+		}
+
+		struct Block
+		{
+			std::unique_ptr<char[]> data;
+			size_t size;
 		};
 
-		DataTypeRef(int32_t& i) { m_ptr.pi = &i; m_type = DTR_INT; }
+		std::vector<Block> m_blocks;
+		size_t m_blockSize;
+		size_t m_block;
+		size_t m_offset;
+		size_t m_used;
+		size_t m_reserved;
+	};
 
-		DataTypeRef(uint32_t& ui) { m_ptr.pui = &ui; m_type = DTR_UINT; }
+	// Standard allocator over a StringArena, for containers and strings
+	// such as std::basic_string<char, std::char_traits<char>,
+	// ArenaAllocator<char>>. Deallocating does nothing: the memory is
+	// released with the arena.
+	template<typename T>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
 
-		DataTypeRef(int16_t& si) { m_ptr.psi = &si; m_type = DTR_SHORT; }
+		explicit ArenaAllocator(StringArena& arena) : m_arena(&arena) {}
 
-		DataTypeRef(uint16_t& usi) { m_ptr.pusi = &usi; m_type = DTR_USHORT; }
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.Arena()) {}
 
-		DataTypeRef(int64_t& i64) { m_ptr.pi64 = &i64; m_type = DTR_INT64; }
+		T* allocate(size_t n)
+		{
+			if (n > static_cast<size_t>(-1) / sizeof(T))
+				throw std::bad_alloc();
+			return static_cast<T*>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+		}
 
-		DataTypeRef(uint64_t& ui64) { m_ptr.pui64 = &ui64; m_type = DTR_UINT64; }
+		void deallocate(T*, size_t) {}
 
-		DataTypeRef(float& f) { m_ptr.pf = &f; m_type = DTR_FLOAT; }
+		StringArena* Arena() const { return m_arena; }
 
-		DataTypeRef(double& d) { m_ptr.pd = &d; m_type = DTR_DOUBLE; }
+	private:
+		StringArena* m_arena;
+	};
 
-		DataTypeRef(std::string& s) { m_ptr.ps = &s; m_type = DTR_STR; }
+	template<typename T, typename U>
+	bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+	{
+		return a.Arena() == b.Arena();
+	}
 
-		DataTypeRef(std::wstring& ws) { m_ptr.pws = &ws; m_type = DTR_WSTR; }
+	template<typename T, typename U>
+	bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+	{
+		return a.Arena() != b.Arena();
+	}
 
-		DataTypeRef(char& c) { m_ptr.pc = &c; m_type = DTR_CHAR; }
+	// Destination of a string field which is copied into a StringArena.
+	// Unlike a StringView, it does not point into the input, and unlike a
+	// std::string, it does not allocate on its own. Each extraction copies
+	// the field again; the previous copy is released with the arena.
+	class ArenaString
+	{
+	public:
+		explicit ArenaString(StringArena& arena) : m_arena(&arena) {}
 
-		DataTypeRef(unsigned char& uc) { m_ptr.puc = &uc; m_type = DTR_UCHAR; }
+		void Assign(StringView str) { m_view = m_arena->Copy(str); }
 
-		DataTypeRef(wchar_t& wc) { m_ptr.pwc = &wc; m_type = DTR_WCHAR; }
+		StringView View() const { return m_view; }
 
-		static std::string TrimRight(const std::string& str, const std::string& trimChars)
+		operator StringView() const { return m_view; }
+
+		const char* data() const { return m_view.data; }
+
+		size_t size() const { return m_view.size; }
+
+		bool empty() const { return m_view.empty(); }
+
+		std::string ToString() const { return m_view.ToString(); }
+
+		StringArena& Arena() const { return *m_arena; }
+
+	private:
+		StringArena* m_arena;
+		StringView m_view;
+	};
+
+	inline std::ostream& operator<<(std::ostream& os, const ArenaString& str)
+	{
+		return os << str.View();
+	}
+
+	namespace detail
+	{
+		// Copies a short slice to a NUL-terminated stack buffer for the C
+		// conversion functions. Only slices longer than the buffer allocate.
+		class CStrBuffer
 		{
-			std::string result = "";
-			// trim trailing spaces
-			size_t endpos = str.find_last_not_of(trimChars);
-			if (std::string::npos != endpos)
+		public:
+			explicit CStrBuffer(StringView str)
 			{
-				result = str.substr(0, endpos + 1);
+				if (str.size < sizeof(m_buf))
+				{
+					memcpy(m_buf, str.data, str.size);
+					m_buf[str.size] = '\0';
+					m_str = m_buf;
+				}
+				else
+				{
+					m_long.assign(str.data, str.size);
+					m_str = m_long.c_str();
+				}
 			}
-			else
-				result = str;
 
-			return result;
+			const char* c_str() const { return m_str; }
+
+		private:
+			char m_buf[64];
+			std::string m_long;
+			const char* m_str;
+		};
+
+		// Rough frequency of a byte in log lines, from spaces, separators
+		// and lowercase letters down to other punctuation and control bytes
+		VALUES_CONSTEXPR14 int ByteRank(unsigned char c)
+		{
+			return (c == ' ') ? 6
+				: (c == 'e' || c == 't' || c == 'a' || c == 'o' || c == 'i' || c == 'n' || c == 's' || c == 'r') ? 5
+				: (c == ':' || c == ',' || c == '=' || c == '.' || c == '/' || c == '-' || c == '_') ? 5
+				: (c >= '0' && c <= '9') ? 5
+				: (c >= 'a' && c <= 'z') ? 4
+				: (c >= 'A' && c <= 'Z') ? 3
+				: (c >= 0x20 && c < 0x7F) ? 2
+				: 1;
 		}
 
-		static std::string TrimLeft(const std::string& str, const std::string& trimChars)
+		VALUES_CONSTEXPR14 Searcher MakeSearcher(const char* find, size_t size)
 		{
-			std::string result = "";
+			Searcher searcher;
+			searcher.size = size;
+			if (size < 2)
+				return searcher;
 
-			// trim leading spaces
-			size_t startpos = str.find_first_not_of(trimChars);
-			if (std::string::npos != startpos)
+			size_t rarest = 0;
+			for (size_t i = 1; i < size; ++i)
 			{
-				result = str.substr(startpos);
+				if (ByteRank(static_cast<unsigned char>(find[i])) < ByteRank(static_cast<unsigned char>(find[rarest])))
+					rarest = i;
 			}
-			else
-				result = str;
+			// the second anchor is the rarest of the others, the last one on
+			// a tie so that the anchors are apart
+			size_t second = (rarest == 0) ? 1 : 0;
+			for (size_t i = second + 1; i < size; ++i)
+			{
+				if (i != rarest && ByteRank(static_cast<unsigned char>(find[i])) <= ByteRank(static_cast<unsigned char>(find[second])))
+					second = i;
+			}
+			searcher.offset1 = static_cast<uint32_t>(rarest);
+			searcher.offset2 = static_cast<uint32_t>(second);
+			return searcher;
+		}
 
-			return result;
+		inline Searcher MakeSearcher(StringView find)
+		{
+			return MakeSearcher(find.data, find.size);
 		}
 
-		static std::string Trim(const std::string& str, const std::string& trimChars)
+#if defined(VALUES_SSE2) || defined(VALUES_AVX2)
+		inline unsigned CountTrailingZeros(uint32_t mask)
 		{
-			return TrimLeft(TrimRight(str, trimChars), trimChars);
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return static_cast<unsigned>(index);
+#else
+			return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
 		}
+#endif
 
-		bool ConvStrToType(const std::string& str, TokenType tokenType)
+		// Knuth-Morris-Pratt: linear in the input whatever the delimiter and
+		// the input are. Search falls back to it when comparing candidates
+		// costs more than the input they are in.
+		inline size_t SearchLinear(StringView input, StringView find, size_t pos)
 		{
-			using namespace std;
-			int base = (tokenType == TokenType::Hex) ? 16 : 10;
+			size_t local[64];
+			std::vector<size_t> heap;
+			size_t* fail = local;
+			if (find.size > 64)
+			{
+				heap.resize(find.size);
+				fail = heap.data();
+			}
 
-			int offset = 0;
-			if (base == 16)
+			fail[0] = 0;
+			for (size_t i = 1, k = 0; i < find.size; ++i)
 			{
-				if (str.size() >= 2 && str.at(0) == '0' && str.at(1) == 'x')
-				{
-					offset = 2;
-				}
+				while (k > 0 && find[i] != find[k])
+					k = fail[k - 1];
+				if (find[i] == find[k])
+					++k;
+				fail[i] = k;
+			}
+
+			for (size_t i = pos, k = 0; i < input.size; ++i)
+			{
+				while (k > 0 && input[i] != find[k])
+					k = fail[k - 1];
+				if (input[i] == find[k])
+					++k;
+				if (k == find.size)
+					return i + 1 - find.size;
 			}
+			return StringView::npos;
+		}
 
-			if (m_type != DTR_STR && m_type != DTR_WSTR)
+		// Looks for the rarest byte of the delimiter with memchr from i, which
+		// is the fastest while that byte is rare in the input. Returns false
+		// after maxMisses false positives or when the budget of bytes to
+		// compare is spent, with i where it stopped.
+		inline bool SearchRareByte(StringView input, StringView find, const Searcher& searcher,
+			size_t end, size_t& i, size_t& found, size_t maxMisses, size_t& budget)
+		{
+			const char* data = input.data;
+			const char rare = find[searcher.offset1];
+			for (size_t misses = 0; misses < maxMisses; ++misses)
 			{
-				if (str.empty())
+				const char* hit = (i < end) ? static_cast<const char*>(memchr(data + i + searcher.offset1, rare, end - i)) : nullptr;
+				if (hit == nullptr)
+				{
+					found = StringView::npos;
+					return true;
+				}
+				i = (hit - data) - searcher.offset1;
+				if (budget < find.size)
+					return false;
+				budget -= find.size;
+				if (memcmp(data + i, find.data, find.size) == 0)
 				{
-					throw std::runtime_error("Value is a empty string!");
+					found = i;
+					return true;
 				}
+				++i;
 			}
+			return false;
+		}
 
-			switch (m_type)
-			{
-			case DTR_INT:
+		// Same result as std::string::find, but on a view. The rarest byte
+		// is looked for with memchr first; when it turns out to be frequent
+		// in the input, the positions where both anchor bytes match are
+		// found 16 or 32 at once and compared in full. The bytes compared are
+		// bounded by twice the input searched: past that, the input is made
+		// to defeat the anchor bytes and the rest is searched in linear time.
+		inline size_t Search(StringView input, StringView find, const Searcher& stored, size_t pos)
+		{
+			if (pos > input.size || input.size - pos < find.size)
+				return StringView::npos;
+			if (find.empty())
+				return pos;
+			if (find.size == 1)
 			{
-				*(m_ptr.pi) = strtol(str.c_str() + offset, nullptr, base);
-				return true;
+				const void* found = memchr(input.data + pos, find[0], input.size - pos);
+				return found ? static_cast<const char*>(found) - input.data : StringView::npos;
 			}
-			case DTR_UINT:
+
+			const Searcher searcher = (stored.size == find.size) ? stored : MakeSearcher(find);
+			const char* data = input.data;
+			const size_t end = input.size - find.size + 1;
+			size_t i = pos;
+			size_t found = StringView::npos;
+			size_t budget = 2 * (input.size - pos) + 4 * find.size;
+			if (SearchRareByte(input, find, searcher, end, i, found, 4, budget))
+				return found;
+#ifdef VALUES_AVX2
+			const __m256i byte1 = _mm256_set1_epi8(find[searcher.offset1]);
+			const __m256i byte2 = _mm256_set1_epi8(find[searcher.offset2]);
+			for (; i + 32 <= end; i += 32)
 			{
-				*(m_ptr.pui) = strtol(str.c_str() + offset, nullptr, base);
-				return true;
+				__m256i block1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + searcher.offset1));
+				__m256i block2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + searcher.offset2));
+				uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+					_mm256_and_si256(_mm256_cmpeq_epi8(block1, byte1), _mm256_cmpeq_epi8(block2, byte2))));
+				while (mask != 0)
+				{
+					size_t candidate = i + CountTrailingZeros(mask);
+					if (budget < find.size)
+						return SearchLinear(input, find, candidate);
+					budget -= find.size;
+					if (memcmp(data + candidate, find.data, find.size) == 0)
+						return candidate;
+					mask &= mask - 1;
+				}
 			}
-			case DTR_SHORT:
+#endif
+#ifdef VALUES_SSE2
+			const __m128i byte1x = _mm_set1_epi8(find[searcher.offset1]);
+			const __m128i byte2x = _mm_set1_epi8(find[searcher.offset2]);
+			for (; i + 16 <= end; i += 16)
 			{
-				*(m_ptr.psi) = (int16_t)(strtol(str.c_str() + offset, nullptr, base));
-				return true;
+				const char* block = data + i;
+				uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(
+					_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + searcher.offset1)), byte1x),
+					_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + searcher.offset2)), byte2x))));
+				if (i + 32 <= end)
+				{
+					// two blocks at once while there is room
+					mask |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(
+						_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 + searcher.offset1)), byte1x),
+						_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 + searcher.offset2)), byte2x)))) << 16;
+					i += 16;
+				}
+				while (mask != 0)
+				{
+					size_t candidate = (block - data) + CountTrailingZeros(mask);
+					if (budget < find.size)
+						return SearchLinear(input, find, candidate);
+					budget -= find.size;
+					if (memcmp(data + candidate, find.data, find.size) == 0)
+						return candidate;
+					mask &= mask - 1;
+				}
 			}
-			case DTR_USHORT:
+#endif
+			if (SearchRareByte(input, find, searcher, end, i, found, StringView::npos, budget))
+				return found;
+			return SearchLinear(input, find, i);
+		}
+
+		inline size_t Search(StringView input, StringView find, size_t pos)
+		{
+			return Search(input, find, Searcher(), pos);
+		}
+
+		// Position of the delimiter at or after pos: an anchored delimiter is
+		// compared where it has to be instead of being searched for.
+		inline size_t Locate(StringView input, StringView find, const Searcher& searcher, const Anchor& anchor, size_t pos)
+		{
+			if (anchor.kind == AnchorKind::None)
+				return Search(input, find, searcher, pos);
+
+			size_t at = anchor.offset;
+			if (anchor.kind == AnchorKind::End)
 			{
-				*(m_ptr.pusi) = (uint16_t)(strtol(str.c_str() + offset, nullptr, base));
-				return true;
+				if (input.size < find.size)
+					return StringView::npos;
+				at = input.size - find.size;
 			}
-			case DTR_FLOAT:
+			if (at < pos || at > input.size || input.size - at < find.size)
+				return StringView::npos;
+			if (find.size != 0 && memcmp(input.data + at, find.data, find.size) != 0)
+				return StringView::npos;
+			return at;
+		}
+
+		enum CharClass : uint8_t
+		{
+			ClassDigit = 1,
+			ClassWord = 2,
+			ClassAlnum = 4,
+			ClassIpv4 = 8,
+			ClassIpv6 = 16,
+			ClassMac = 32
+		};
+
+		constexpr uint8_t CharClassOf(unsigned c)
+		{
+			return static_cast<uint8_t>(
+				((c >= '0' && c <= '9') ? ClassDigit | ClassAlnum | ClassIpv4 | ClassIpv6 | ClassMac : 0) |
+				(((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) ? ClassAlnum : 0) |
+				(((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) ? ClassIpv6 | ClassMac : 0) |
+				((c == '.') ? ClassIpv4 | ClassIpv6 | ClassMac : 0) |
+				((c == ':') ? ClassIpv6 | ClassMac : 0) |
+				((c == '-') ? ClassMac : 0) |
+				((c != ' ' && (c < '\t' || c > '\r')) ? ClassWord : 0));
+		}
+
+#define VALUES_CLASS4(c) CharClassOf(c), CharClassOf(c + 1), CharClassOf(c + 2), CharClassOf(c + 3)
+#define VALUES_CLASS16(c) VALUES_CLASS4(c), VALUES_CLASS4(c + 4), VALUES_CLASS4(c + 8), VALUES_CLASS4(c + 12)
+#define VALUES_CLASS64(c) VALUES_CLASS16(c), VALUES_CLASS16(c + 16), VALUES_CLASS16(c + 32), VALUES_CLASS16(c + 48)
+
+		// The classes of each byte, for {d}, {w}, {a} and the addresses
+		template<typename T = void>
+		struct CharClassTable
+		{
+			static constexpr uint8_t classes[256] =
 			{
-				*(m_ptr.pf) = strtof(str.c_str(), nullptr);
-				return true;
-			}
-			case DTR_DOUBLE:
+				VALUES_CLASS64(0), VALUES_CLASS64(64), VALUES_CLASS64(128), VALUES_CLASS64(192)
+			};
+		};
+
+		template<typename T>
+		constexpr uint8_t CharClassTable<T>::classes[256];
+
+#undef VALUES_CLASS64
+#undef VALUES_CLASS16
+#undef VALUES_CLASS4
+
+		// The class which ends a field of this type, 0 if its postfix does
+		inline uint8_t FieldClass(TokenType type)
+		{
+			switch (type)
 			{
-				*(m_ptr.pd) = strtod(str.c_str(), nullptr);
-				return true;
+			case TokenType::Digits: return ClassDigit;
+			case TokenType::Word: return ClassWord;
+			case TokenType::Alnum: return ClassAlnum;
+			case TokenType::Ipv4: return ClassIpv4;
+			case TokenType::Ipv6: return ClassIpv6;
+			case TokenType::Mac: return ClassMac;
+			default: return 0;
 			}
-			case DTR_STR:
-				if (tokenType == TokenType::Trim)
-				{
-					std::string str2 = Trim(str, " \r\n\t\v");
-					*(m_ptr.ps) = str2;
+		}
+
+		// End of the run of characters of the class from pos
+		inline size_t ScanClass(StringView input, size_t pos, uint8_t charClass)
+		{
+			const uint8_t* classes = CharClassTable<>::classes;
+			while (pos < input.size && (classes[static_cast<unsigned char>(input.data[pos])] & charClass) != 0)
+				++pos;
+			return pos;
+		}
+
+		inline StringView DefaultTimestampLayout()
+		{
+			return StringView("%Y-%m-%d %H:%M:%S.%f");
+		}
+
+		// End of the text matched by a {ts} layout from pos: the digits of
+		// each conversion and the other characters as they are. It stops at
+		// the first mismatch, which ParseTimestamp reports.
+		inline size_t ScanTimestamp(StringView input, size_t pos, StringView layout)
+		{
+			const uint8_t* classes = CharClassTable<>::classes;
+			for (size_t i = 0; i < layout.size; ++i)
+			{
+				const char code = (layout[i] == '%' && i + 1 < layout.size) ? layout[++i] : '%';
+				if (code == '%')
+				{
+					if (pos == input.size || input[pos] != layout[i])
+						return pos;
+					++pos;
+					continue;
+				}
+
+				const size_t digits = (code == 'f') ? 9 : (code == 'Y') ? 4 : 2;
+				const size_t start = pos;
+				while (pos < input.size && pos - start < digits && (classes[static_cast<unsigned char>(input.data[pos])] & ClassDigit) != 0)
+					++pos;
+				if (pos == start || (code != 'f' && pos - start < digits))
+					return pos;
+			}
+			return pos;
+		}
+
+		// A literal of the fmt, with how it is searched for and where it has
+		// to be
+		struct Delimiter
+		{
+			StringView text;
+			Searcher searcher;
+			Anchor anchor;
+		};
+
+		// Locates the field between prefix and postfix, searching from pos.
+		// This is the only matcher: ValuesExtract, IsInputMatchedTokens,
+		// CompiledFormat, FormatSet and BatchExtractor all go through it.
+		//
+		// Each delimiter is taken at its leftmost occurrence and a taken
+		// delimiter is never reconsidered. The prefix is the first one at or
+		// after pos. The postfix is the first one after the first character
+		// of the field, so the field is the shortest one which is not empty;
+		// it is empty only if the postfix directly follows the prefix and is
+		// not found further. The field before an anchored postfix ends where
+		// the postfix is. A field with a width is sliced, one of {d}, {w} or
+		// {a} ends at the first character out of its class, and the postfix
+		// has to follow it.
+		//
+		// Each search starts where the previous one ended and Search is
+		// linear, so a line is matched in time linear in its length plus the
+		// length of the fmt, whatever the input.
+		//
+		// On success, pos is moved to the end of the field, on failure to
+		// where the missing delimiter was searched from.
+		// layout is the one of a {ts} field, which ends where its layout does
+		inline ExtractError FindField(StringView input, const Delimiter& prefix, const Delimiter& postfix, size_t width,
+			TokenType type, StringView layout, size_t& pos, StringView& field)
+		{
+			size_t prefix_pos = pos;
+			if (prefix.text.empty() == false || prefix.anchor.Anchored())
+			{
+				prefix_pos = Locate(input, prefix.text, prefix.searcher, prefix.anchor, prefix_pos);
+
+				if (prefix_pos == StringView::npos)
+					return ExtractError::PrefixNotFound;
+
+				prefix_pos += prefix.text.size;
+			}
+
+			size_t postfix_pos = StringView::npos;
+			const uint8_t charClass = FieldClass(type);
+			const bool timestamp = (type == TokenType::Timestamp);
+			if (width == 0 && charClass != 0)
+				width = ScanClass(input, prefix_pos, charClass) - prefix_pos;
+			else if (width == 0 && timestamp)
+				width = ScanTimestamp(input, prefix_pos, layout.empty() ? DefaultTimestampLayout() : layout) - prefix_pos;
+			if (width != 0 || charClass != 0 || timestamp)
+			{
+				// the postfix is compared where the field ends
+				postfix_pos = prefix_pos + width;
+				const Anchor at = postfix.anchor.Anchored() ? postfix.anchor : Anchor(AnchorKind::Offset, postfix_pos);
+				if (input.size - prefix_pos < width || Locate(input, postfix.text, postfix.searcher, at, postfix_pos) != postfix_pos)
+				{
+					pos = prefix_pos;
+					return ExtractError::PostfixNotFound;
+				}
+			}
+			else if (postfix.anchor.Anchored())
+			{
+				postfix_pos = Locate(input, postfix.text, postfix.searcher, postfix.anchor, prefix_pos);
+				if (postfix_pos == StringView::npos)
+				{
+					pos = prefix_pos;
+					return ExtractError::PostfixNotFound;
+				}
+			}
+			else if (postfix.text.empty() == false)
+			{
+				postfix_pos = Search(input, postfix.text, postfix.searcher, prefix_pos + 1);
+
+				if (postfix_pos == StringView::npos)
+				{
+					// only an empty field is left
+					if (input.substr(prefix_pos, postfix.text.size) != postfix.text)
+					{
+						pos = prefix_pos;
+						return ExtractError::PostfixNotFound;
+					}
+					postfix_pos = prefix_pos;
 				}
+			}
+
+			if (postfix_pos == StringView::npos)
+				field = input.substr(prefix_pos);
+			else
+				field = input.substr(prefix_pos, postfix_pos - prefix_pos);
+			pos = prefix_pos + field.size;
+			return ExtractError::None;
+		}
+
+		// The characters trimmed by a {t} field without a set of its own
+		inline StringView DefaultTrimChars()
+		{
+			return StringView(" \r\n\t\v", 5);
+		}
+
+		inline StringView TrimView(StringView str, StringView trimChars)
+		{
+			size_t first = 0;
+			size_t last = str.size;
+			while (first < last && memchr(trimChars.data, str[first], trimChars.size) != nullptr)
+				++first;
+			while (last > first && memchr(trimChars.data, str[last - 1], trimChars.size) != nullptr)
+				--last;
+
+			return StringView(str.data + first, last - first);
+		}
+
+		// Narrows a {t} field to its trimmed bounds; nothing is copied, so
+		// the field can be converted into any type
+		inline StringView TrimField(StringView str, TokenType tokenType, StringView trimChars)
+		{
+			if (tokenType != TokenType::Trim)
+				return str;
+			return TrimView(str, trimChars.empty() ? DefaultTrimChars() : trimChars);
+		}
+
+		// The line from begin to end, without the '\r' of a "\r\n"
+		inline StringView MakeLine(const char* begin, const char* end)
+		{
+			if (end != begin && end[-1] == '\r')
+				--end;
+			return StringView(begin, end - begin);
+		}
+
+		inline ExtractError FindField(StringView input, StringView prefix, StringView postfix, size_t& pos, StringView& field)
+		{
+			const Delimiter prefixDelimiter = { prefix, Searcher(), Anchor() };
+			const Delimiter postfixDelimiter = { postfix, Searcher(), Anchor() };
+			return FindField(input, prefixDelimiter, postfixDelimiter, 0, TokenType::Matter, StringView(), pos, field);
+		}
+
+		inline ExtractError FindField(StringView input, const Token& token, size_t& pos, StringView& field)
+		{
+			const Delimiter prefix = { token.prefix, token.prefixSearcher, token.prefixAnchor };
+			const Delimiter postfix = { token.postfix, token.postfixSearcher, token.postfixAnchor };
+			ExtractError error = FindField(input, prefix, postfix, token.width, token.type, token.layout, pos, field);
+			field = TrimField(field, token.type, token.trimChars);
+			return error;
+		}
+
+		struct ParseResult
+		{
+			// first character which is not part of the number, or the
+			// start of the slice if no number was found
+			const char* ptr;
+			bool overflow;
+		};
+
+		inline bool IsDigit(char ch)
+		{
+			return static_cast<unsigned char>(ch - '0') < 10;
+		}
+
+		inline bool IsSpace(char ch)
+		{
+			return ch == ' ' || (ch >= '\t' && ch <= '\r');
+		}
+
+		inline int HexDigitValue(char ch)
+		{
+			unsigned char c = static_cast<unsigned char>(ch);
+			if (static_cast<unsigned char>(c - '0') < 10)
+				return c - '0';
+			c |= 0x20;
+			if (static_cast<unsigned char>(c - 'a') < 6)
+				return c - 'a' + 10;
+			return -1;
+		}
+
+#ifdef VALUES_SWAR
+		inline bool IsEightDigits(uint64_t chunk)
+		{
+			return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+				(((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+		}
+
+		// Combines 8 ASCII digits pairwise: 3 multiplications instead of 8
+		inline uint64_t ParseEightDigits(uint64_t chunk)
+		{
+			const uint64_t mask = 0x000000FF000000FFULL;
+			const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+			const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+			chunk -= 0x3030303030303030ULL;
+			chunk = (chunk * 10) + (chunk >> 8);
+			chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+			return chunk;
+		}
+#endif
+
+		// Parses the decimal digits at the start of [first, last). Up to 19
+		// significant digits cannot overflow, so only the rest is checked.
+		inline ParseResult ParseDecimalDigits(const char* first, const char* last, uint64_t& value)
+		{
+			const char* p = first;
+			while (p != last && *p == '0')
+				++p;
+
+			const char* significant = p;
+			uint64_t v = 0;
+#ifdef VALUES_SWAR
+			while (last - p >= 8 && p - significant <= 11)
+			{
+				uint64_t chunk;
+				memcpy(&chunk, p, sizeof(chunk));
+				if (IsEightDigits(chunk) == false)
+					break;
+				v = v * 100000000 + ParseEightDigits(chunk);
+				p += 8;
+			}
+#endif
+			while (p != last && IsDigit(*p) && p - significant < 19)
+			{
+				v = v * 10 + static_cast<uint64_t>(*p - '0');
+				++p;
+			}
+
+			bool overflow = false;
+			while (p != last && IsDigit(*p))
+			{
+				uint64_t digit = static_cast<uint64_t>(*p - '0');
+				if (v > (UINT64_MAX - digit) / 10)
+					overflow = true;
+				else
+					v = v * 10 + digit;
+				++p;
+			}
+
+			value = v;
+			ParseResult res = { p, overflow };
+			return res;
+		}
+
+		inline ParseResult ParseHexDigits(const char* first, const char* last, uint64_t& value)
+		{
+			const char* p = first;
+			while (p != last && *p == '0')
+				++p;
+
+			const char* significant = p;
+			uint64_t v = 0;
+			bool overflow = false;
+			int digit = 0;
+			while (p != last && (digit = HexDigitValue(*p)) >= 0)
+			{
+				if (p - significant >= 16)
+					overflow = true;
 				else
+					v = (v << 4) | static_cast<uint64_t>(digit);
+				++p;
+			}
+
+			value = v;
+			ParseResult res = { p, overflow };
+			return res;
+		}
+
+		// Parses an integer the way strtol does (leading spaces, a sign and
+		// for base 16 a 0x prefix are accepted, parsing stops at the first
+		// invalid character) but from a slice and without a locale.
+		inline ParseResult ParseInteger(StringView str, int base, uint64_t& magnitude, bool& negative)
+		{
+			const char* p = str.begin();
+			const char* last = str.end();
+			while (p != last && IsSpace(*p))
+				++p;
+
+			negative = false;
+			if (p != last && (*p == '-' || *p == '+'))
+			{
+				negative = (*p == '-');
+				++p;
+			}
+
+			ParseResult res = { str.begin(), false };
+			if (base == 16)
+			{
+				if (last - p >= 3 && p[0] == '0' && (p[1] | 0x20) == 'x' && HexDigitValue(p[2]) >= 0)
+					p += 2;
+				ParseResult digits = ParseHexDigits(p, last, magnitude);
+				if (digits.ptr != p)
+					res = digits;
+			}
+			else
+			{
+				ParseResult digits = ParseDecimalDigits(p, last, magnitude);
+				if (digits.ptr != p)
+					res = digits;
+			}
+			return res;
+		}
+
+		template<typename T> struct FloatTraits;
+
+		template<> struct FloatTraits<float>
+		{
+			static const uint64_t maxExactMantissa = uint64_t(1) << 24;
+			static const int maxExactPow10 = 10;
+			static float Pow10(int e)
+			{
+				static const float table[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+				return table[e];
+			}
+			static float StrTo(const char* str, char** end) { return strtof(str, end); }
+		};
+
+		template<> struct FloatTraits<double>
+		{
+			static const uint64_t maxExactMantissa = uint64_t(1) << 53;
+			static const int maxExactPow10 = 22;
+			static double Pow10(int e)
+			{
+				static const double table[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+					1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+				return table[e];
+			}
+			static double StrTo(const char* str, char** end) { return strtod(str, end); }
+		};
+
+		// Clinger's fast path: when the decimal mantissa and the power of ten
+		// are both exact in T, a single multiplication or division gives the
+		// correctly rounded result. Returns false when the number needs the
+		// slow path (long mantissa, large exponent, inf, nan, hex float).
+		template<typename T>
+		bool ParseFloatFast(StringView str, T& value, const char*& end)
+		{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+			const char* p = str.begin();
+			const char* last = str.end();
+			while (p != last && IsSpace(*p))
+				++p;
+
+			bool negative = false;
+			if (p != last && (*p == '-' || *p == '+'))
+			{
+				negative = (*p == '-');
+				++p;
+			}
+
+			uint64_t mantissa = 0;
+			int digits = 0;
+			int exponent = 0;
+			const char* start = p;
+			while (p != last && IsDigit(*p))
+			{
+				if (mantissa != 0 || *p != '0')
+				{
+					if (++digits > 19)
+						return false;
+				}
+				mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+				++p;
+			}
+			bool anyDigit = (p != start);
+			if (p != last && (*p == 'x' || *p == 'X'))
+				return false;
+
+			if (p != last && *p == '.')
+			{
+				++p;
+				const char* frac = p;
+				while (p != last && IsDigit(*p))
+				{
+					if (mantissa != 0 || *p != '0')
+					{
+						if (++digits > 19)
+							return false;
+					}
+					mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+					--exponent;
+					++p;
+				}
+				anyDigit = anyDigit || (p != frac);
+			}
+			if (anyDigit == false)
+				return false;
+
+			if (p != last && (*p == 'e' || *p == 'E'))
+			{
+				const char* q = p + 1;
+				bool negativeExp = false;
+				if (q != last && (*q == '-' || *q == '+'))
+				{
+					negativeExp = (*q == '-');
+					++q;
+				}
+				if (q != last && IsDigit(*q))
 				{
-					*(m_ptr.ps) = str;
+					int exp = 0;
+					while (q != last && IsDigit(*q))
+					{
+						if (exp < 10000)
+							exp = exp * 10 + (*q - '0');
+						++q;
+					}
+					exponent += negativeExp ? -exp : exp;
+					p = q;
 				}
+			}
+
+			if (mantissa == 0)
+			{
+				value = negative ? -T(0) : T(0);
+				end = p;
 				return true;
-			case DTR_WSTR:
+			}
+			if (mantissa > FloatTraits<T>::maxExactMantissa)
+				return false;
+			if (exponent < -FloatTraits<T>::maxExactPow10 || exponent > FloatTraits<T>::maxExactPow10)
+				return false;
+
+			T v = static_cast<T>(mantissa);
+			if (exponent < 0)
+				v = v / FloatTraits<T>::Pow10(-exponent);
+			else
+				v = v * FloatTraits<T>::Pow10(exponent);
+			value = negative ? -v : v;
+			end = p;
+			return true;
+#else
+			(void)str;
+			(void)value;
+			(void)end;
+			return false;
+#endif
+		}
+
+		// Parses with std::from_chars where the library has it, else strtod.
+		// Overflow is reported instead of returning infinity; underflow
+		// gives zero or a denormal as strtod does.
+		template<typename T>
+		ParseResult ParseFloatSlow(StringView str, T& value)
+		{
+			const char* p = str.begin();
+			const char* last = str.end();
+			while (p != last && IsSpace(*p))
+				++p;
+			if (p != last && *p == '+' && last - p > 1 && p[1] != '-')
+				++p;
+
+#ifdef VALUES_HAS_FROM_CHARS_FLOAT
+			bool hex = (last - p >= 2 && p[0] == '0' && (p[1] | 0x20) == 'x') ||
+				(last - p >= 3 && p[0] == '-' && p[1] == '0' && (p[2] | 0x20) == 'x');
+			if (hex == false)
+			{
+				std::from_chars_result res = std::from_chars(p, last, value);
+				if (res.ec == std::errc())
+				{
+					ParseResult ok = { res.ptr, false };
+					return ok;
+				}
+			}
+#endif
+			CStrBuffer buf(str);
+			char* end = nullptr;
+			T v = FloatTraits<T>::StrTo(buf.c_str(), &end);
+
+			ParseResult res = { str.begin() + (end - buf.c_str()), false };
+			bool negative = (p != last && *p == '-');
+			const char* name = negative ? p + 1 : p;
+			bool infLiteral = (name != last && (*name | 0x20) == 'i');
+			if (std::isinf(v) && infLiteral == false)
+				res.overflow = true;
+			else
+				value = v;
+			return res;
+		}
+
+		// Error of a parsed number: the whole field must be the number
+		inline ExtractError NumberError(StringView str, ParseResult res)
+		{
+			if (res.ptr == str.begin())
+				return ExtractError::InvalidValue;
+			if (res.overflow)
+				return ExtractError::OutOfRange;
+			if (res.ptr != str.end())
+				return ExtractError::TrailingChars;
+			return ExtractError::None;
+		}
+
+		// Range check of a magnitude and sign against T. A {h} value may use
+		// all the bits of a signed type, so 0xFFFFFFFF fits in an int32_t.
+		template<typename T>
+		bool FitsIn(uint64_t magnitude, bool negative, TokenType tokenType)
+		{
+			typedef typename std::make_unsigned<T>::type U;
+			const uint64_t max = static_cast<uint64_t>(std::numeric_limits<T>::max());
+			if (std::is_signed<T>::value)
+			{
+				if (negative)
+					return magnitude <= max + 1;
+				if (tokenType == TokenType::Hex)
+					return magnitude <= static_cast<uint64_t>(std::numeric_limits<U>::max());
+				return magnitude <= max;
+			}
+			return negative ? magnitude == 0 : magnitude <= max;
+		}
+
+		// Dotted decimal, as inet_pton takes it: 4 numbers up to 255
+		// without a leading zero. The address is in host order, the first
+		// number in the high byte.
+		inline ExtractError ParseIpv4(StringView str, uint32_t& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+
+			uint32_t address = 0;
+			size_t pos = 0;
+			for (int part = 0; part < 4; ++part)
+			{
+				if (part != 0)
+				{
+					if (pos == str.size || str[pos] != '.')
+						return ExtractError::InvalidValue;
+					++pos;
+				}
+
+				const size_t start = pos;
+				unsigned number = 0;
+				while (pos < str.size && pos - start < 3 && IsDigit(str[pos]))
+					number = number * 10 + static_cast<unsigned>(str[pos++] - '0');
+				if (pos == start || (pos - start > 1 && str[start] == '0'))
+					return ExtractError::InvalidValue;
+				if (number > 255)
+					return ExtractError::OutOfRange;
+				address = address << 8 | number;
+			}
+			if (pos != str.size)
+				return ExtractError::TrailingChars;
+			value = address;
+			return ExtractError::None;
+		}
+
+		// On OutOfRange, the value is left unchanged. On TrailingChars, the
+		// number before the trailing characters is stored. An {ip} field is
+		// an IPv4 address.
+		template<typename T>
+		ExtractError ConvertInteger(StringView str, TokenType tokenType, T& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+
+			if (tokenType == TokenType::Ipv4)
+			{
+				uint32_t address = 0;
+				const ExtractError error = ParseIpv4(str, address);
+				if (error != ExtractError::None)
+					return error;
+				if (FitsIn<T>(address, false, tokenType) == false)
+					return ExtractError::OutOfRange;
+				value = static_cast<T>(address);
+				return ExtractError::None;
+			}
+
+			uint64_t magnitude = 0;
+			bool negative = false;
+			ParseResult res = ParseInteger(str, (tokenType == TokenType::Hex) ? 16 : 10, magnitude, negative);
+			if (res.ptr != str.begin() && res.overflow == false && FitsIn<T>(magnitude, negative, tokenType) == false)
+				res.overflow = true;
+
+			ExtractError error = NumberError(str, res);
+			if (error == ExtractError::None || error == ExtractError::TrailingChars)
+				value = static_cast<T>(negative ? 0 - magnitude : magnitude);
+			return error;
+		}
+
+		template<typename T>
+		ExtractError ConvertFloat(StringView str, T& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+
+			ParseResult res = { str.begin(), false };
+			if (ParseFloatFast(str, value, res.ptr) == false)
+				res = ParseFloatSlow(str, value);
+			return NumberError(str, res);
+		}
+
+		// The unchecked API has always thrown on an empty value and ignored
+		// the other conversion errors.
+		inline ExtractError ThrowIfEmpty(ExtractError error)
+		{
+			if (error == ExtractError::EmptyValue)
+				throw std::runtime_error("Value is a empty string!");
+			return error;
+		}
+
+		// Widens the run of ASCII bytes from the start of p into out, 16
+		// bytes at a time with SSE2. Returns the length of the run.
+		template<typename CharT>
+		size_t WidenAscii(const char* p, size_t size, CharT* out)
+		{
+			size_t i = 0;
+#if defined(VALUES_SSE2)
+			const __m128i zero = _mm_setzero_si128();
+			for (; i + 16 <= size; i += 16)
+			{
+				const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+				// the bytes before the first non-ASCII one are widened below
+				if (_mm_movemask_epi8(bytes) != 0)
+					break;
+
+				const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+				const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+				__m128i* dst = reinterpret_cast<__m128i*>(out + i);
+				if (sizeof(CharT) == 2)
+				{
+					_mm_storeu_si128(dst, lo);
+					_mm_storeu_si128(dst + 1, hi);
+				}
+				else
+				{
+					_mm_storeu_si128(dst, _mm_unpacklo_epi16(lo, zero));
+					_mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(lo, zero));
+					_mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(hi, zero));
+					_mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(hi, zero));
+				}
+			}
+#endif
+			for (; i < size && static_cast<unsigned char>(p[i]) < 0x80; ++i)
+				out[i] = static_cast<CharT>(p[i]);
+			return i;
+		}
+
+		// Decodes the sequence at p. Returns its length, 0 if it is not
+		// valid UTF-8: truncated, overlong, a surrogate or above U+10FFFF.
+		inline size_t DecodeCodePoint(const char* p, const char* end, char32_t& cp)
+		{
+			const unsigned char b0 = static_cast<unsigned char>(p[0]);
+			if (b0 < 0x80)
+			{
+				cp = b0;
+				return 1;
+			}
+
+			size_t len = 0;
+			unsigned char low = 0x80;
+			unsigned char high = 0xBF;
+			if (b0 >= 0xC2 && b0 <= 0xDF)
+				len = 2;
+			else if (b0 >= 0xE0 && b0 <= 0xEF)
+			{
+				len = 3;
+				if (b0 == 0xE0)
+					low = 0xA0;
+				else if (b0 == 0xED)
+					high = 0x9F;
+			}
+			else if (b0 >= 0xF0 && b0 <= 0xF4)
+			{
+				len = 4;
+				if (b0 == 0xF0)
+					low = 0x90;
+				else if (b0 == 0xF4)
+					high = 0x8F;
+			}
+			if (len == 0 || static_cast<size_t>(end - p) < len)
+				return 0;
+
+			const unsigned char b1 = static_cast<unsigned char>(p[1]);
+			if (b1 < low || b1 > high)
+				return 0;
+			cp = (b0 & (0x7F >> len)) << 6 | (b1 & 0x3F);
+			for (size_t i = 2; i < len; ++i)
+			{
+				const unsigned char b = static_cast<unsigned char>(p[i]);
+				if ((b & 0xC0) != 0x80)
+					return 0;
+				cp = (cp << 6) | (b & 0x3F);
+			}
+			return len;
+		}
+
+		// UTF-16 for a 2-byte CharT (wchar_t on Windows), UTF-32 otherwise
+		template<typename CharT>
+		CharT* EncodeCodePoint(char32_t cp, CharT* out)
+		{
+			if (sizeof(CharT) == 2 && cp > 0xFFFF)
+			{
+				cp -= 0x10000;
+				*out++ = static_cast<CharT>(0xD800 + (cp >> 10));
+				*out++ = static_cast<CharT>(0xDC00 + (cp & 0x3FF));
+				return out;
+			}
+			*out++ = static_cast<CharT>(cp);
+			return out;
+		}
+
+		// The string is sized once: a code point never takes more UTF-16 or
+		// UTF-32 units than UTF-8 bytes. An invalid sequence is decoded as
+		// U+FFFD.
+		template<typename String>
+		ExtractError DecodeUtf8(StringView str, String& value)
+		{
+			typedef typename String::value_type CharT;
+			value.resize(str.size);
+			if (str.empty())
+				return ExtractError::None;
+
+			CharT* const first = &value[0];
+			CharT* out = first;
+			const char* p = str.begin();
+			const char* end = str.end();
+			ExtractError error = ExtractError::None;
+			while (p != end)
+			{
+				const size_t run = WidenAscii(p, static_cast<size_t>(end - p), out);
+				out += run;
+				p += run;
+				if (p == end)
+					break;
+
+				char32_t cp = 0;
+				size_t len = DecodeCodePoint(p, end, cp);
+				if (len == 0)
+				{
+					cp = 0xFFFD;
+					len = 1;
+					error = ExtractError::InvalidEncoding;
+				}
+				out = EncodeCodePoint(cp, out);
+				p += len;
+			}
+			value.resize(static_cast<size_t>(out - first));
+			return error;
+		}
+
+		// One ConvertTo overload per destination type. The templated
+		// ValuesExtract picks the overload at compile time, DataTypeRef
+		// dispatches to it at runtime.
+		inline ExtractError ConvertTo(StringView str, TokenType tokenType, int32_t& value)
+		{
+			return ConvertInteger(str, tokenType, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType tokenType, uint32_t& value)
+		{
+			return ConvertInteger(str, tokenType, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType tokenType, int16_t& value)
+		{
+			return ConvertInteger(str, tokenType, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType tokenType, uint16_t& value)
+		{
+			return ConvertInteger(str, tokenType, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType tokenType, int64_t& value)
+		{
+			return ConvertInteger(str, tokenType, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType tokenType, uint64_t& value)
+		{
+			return ConvertInteger(str, tokenType, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType, float& value)
+		{
+			return ConvertFloat(str, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType, double& value)
+		{
+			return ConvertFloat(str, value);
+		}
+
+		// Any allocator: the string allocates through it when it grows
+		template<typename Traits, typename Alloc>
+		ExtractError ConvertTo(StringView str, TokenType, std::basic_string<char, Traits, Alloc>& value)
+		{
+			value.assign(str.data, str.size);
+			return ExtractError::None;
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType, ArenaString& value)
+		{
+			value.Assign(str);
+			return ExtractError::None;
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType, StringView& value)
+		{
+			value = str;
+			return ExtractError::None;
+		}
+
+		template<typename Traits, typename Alloc>
+		ExtractError ConvertTo(StringView str, TokenType, std::basic_string<wchar_t, Traits, Alloc>& value)
+		{
+			return DecodeUtf8(str, value);
+		}
+
+		template<typename Traits, typename Alloc>
+		ExtractError ConvertTo(StringView str, TokenType, std::basic_string<char16_t, Traits, Alloc>& value)
+		{
+			return DecodeUtf8(str, value);
+		}
+
+		template<typename Traits, typename Alloc>
+		ExtractError ConvertTo(StringView str, TokenType, std::basic_string<char32_t, Traits, Alloc>& value)
+		{
+			return DecodeUtf8(str, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType, char& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+			value = str[0];
+			return (str.size == 1) ? ExtractError::None : ExtractError::TrailingChars;
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType, unsigned char& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+			value = (unsigned char)str[0];
+			return (str.size == 1) ? ExtractError::None : ExtractError::TrailingChars;
+		}
+
+		// One code point, which has to fit in one wchar_t
+		inline ExtractError ConvertTo(StringView str, TokenType, wchar_t& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+			char32_t cp = 0;
+			const size_t len = DecodeCodePoint(str.begin(), str.end(), cp);
+			if (len == 0)
+				return ExtractError::InvalidEncoding;
+			if (sizeof(wchar_t) == 2 && cp > 0xFFFF)
+				return ExtractError::OutOfRange;
+			value = static_cast<wchar_t>(cp);
+			return (str.size == len) ? ExtractError::None : ExtractError::TrailingChars;
+		}
+
+		// Groups of 1 to 4 hex digits separated by ':', one "::" for the
+		// zero groups, and the last 32 bits in dotted decimal if a '.'
+		// follows, e.g. ::ffff:10.0.0.1. The bytes are in network order.
+		inline ExtractError ParseIpv6(StringView str, std::array<uint8_t, 16>& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+
+			uint16_t groups[8] = {};
+			size_t count = 0;
+			const size_t none = static_cast<size_t>(-1);
+			size_t gap = none; // groups before the "::"
+			size_t pos = 0;
+			if (str.size >= 2 && str[0] == ':' && str[1] == ':')
+			{
+				gap = 0;
+				pos = 2;
+			}
+			while (pos < str.size)
+			{
+				if (count == 8)
+					return ExtractError::TrailingChars;
+
+				size_t end = pos;
+				unsigned group = 0;
+				int digit = 0;
+				while (end < str.size && end - pos < 5 && (digit = HexDigitValue(str[end])) >= 0)
+				{
+					group = group << 4 | static_cast<unsigned>(digit);
+					++end;
+				}
+				if (end < str.size && str[end] == '.')
+				{
+					uint32_t address = 0;
+					if (count > 6 || ParseIpv4(str.substr(pos), address) != ExtractError::None)
+						return ExtractError::InvalidValue;
+					groups[count++] = static_cast<uint16_t>(address >> 16);
+					groups[count++] = static_cast<uint16_t>(address);
+					pos = str.size;
+					break;
+				}
+				if (end == pos || end - pos > 4)
+					return ExtractError::InvalidValue;
+				groups[count++] = static_cast<uint16_t>(group);
+
+				pos = end;
+				if (pos == str.size)
+					break;
+				if (str[pos] != ':' || pos + 1 == str.size)
+					return ExtractError::InvalidValue;
+				++pos;
+				if (str[pos] == ':')
+				{
+					if (gap != none)
+						return ExtractError::InvalidValue;
+					gap = count;
+					++pos;
+				}
+			}
+			if (gap == none ? count != 8 : count == 8)
+				return ExtractError::InvalidValue;
+
+			// the groups after the "::" go to the end
+			const size_t tail = (gap == none) ? 0 : count - gap;
+			std::array<uint8_t, 16> bytes = {};
+			for (size_t i = 0; i < count; ++i)
+			{
+				const size_t at = (i < count - tail) ? i : 8 - count + i;
+				bytes[2 * at] = static_cast<uint8_t>(groups[i] >> 8);
+				bytes[2 * at + 1] = static_cast<uint8_t>(groups[i]);
+			}
+			value = bytes;
+			return ExtractError::None;
+		}
+
+		// 6 bytes of 2 hex digits separated by ':' or '-', or 3 groups of 4
+		// hex digits separated by '.'. The digits are checked once at the
+		// end rather than one by one.
+		inline ExtractError ParseMac(StringView str, std::array<uint8_t, 6>& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+
+			// the offset of each byte in the two forms
+			static const unsigned char colons[6] = { 0, 3, 6, 9, 12, 15 };
+			static const unsigned char dots[6] = { 0, 2, 5, 7, 10, 12 };
+			const unsigned char* offsets = nullptr;
+			if (str.size >= 17 && (str[2] == ':' || str[2] == '-'))
+			{
+				const char sep = str[2];
+				if (str[5] != sep || str[8] != sep || str[11] != sep || str[14] != sep)
+					return ExtractError::InvalidValue;
+				offsets = colons;
+			}
+			else if (str.size >= 14 && str[4] == '.' && str[9] == '.')
+				offsets = dots;
+			else
+				return ExtractError::InvalidValue;
+
+			std::array<uint8_t, 6> bytes;
+			int digits = 0;
+			for (size_t i = 0; i < 6; ++i)
+			{
+				const int high = HexDigitValue(str[offsets[i]]);
+				const int low = HexDigitValue(str[offsets[i] + 1]);
+				digits |= high | low;
+				bytes[i] = static_cast<uint8_t>(static_cast<unsigned>(high) << 4 | static_cast<unsigned>(low));
+			}
+			if (digits < 0)
+				return ExtractError::InvalidValue;
+			if (str.size != offsets[5] + 2u)
+				return ExtractError::TrailingChars;
+			value = bytes;
+			return ExtractError::None;
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType, std::array<uint8_t, 16>& value)
+		{
+			return ParseIpv6(str, value);
+		}
+
+		inline ExtractError ConvertTo(StringView str, TokenType, std::array<uint8_t, 6>& value)
+		{
+			return ParseMac(str, value);
+		}
+
+		// The conversions of a {ts} layout: %Y, %m, %d, %H, %M, %S, %f and %%
+		VALUES_CONSTEXPR14 bool IsTimestampLayout(const char* text, size_t len)
+		{
+			for (size_t i = 0; i < len; ++i)
+			{
+				if (text[i] != '%')
+					continue;
+				if (++i == len)
+					return false;
+				switch (text[i])
+				{
+				case 'Y': case 'm': case 'd': case 'H': case 'M': case 'S': case 'f': case '%':
+					break;
+				default:
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Days since 1970-01-01 of a date of the proleptic Gregorian calendar
+		inline int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day)
+		{
+			year -= (month <= 2) ? 1 : 0;
+			const int64_t era = (year >= 0 ? year : year - 399) / 400;
+			const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+			const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+			const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+			return era * 146097 + static_cast<int64_t>(dayOfEra) - 719468;
+		}
+
+		inline unsigned DaysInMonth(int64_t year, unsigned month)
+		{
+			static const unsigned char days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+			const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+			return (month == 2 && leap) ? 29 : days[month - 1];
+		}
+
+		// Walks the layout and the field together, without locale and
+		// without normalizing a tm: %Y is 4 digits, %m, %d, %H, %M and %S
+		// are 2 digits, and %f is 1 to 9 digits of a fraction of second,
+		// optional when a separator and %f end the layout. The other
+		// characters are matched as they are. The time is UTC.
+		inline ExtractError ParseTimestamp(StringView str, StringView layout, int64_t& value)
+		{
+			if (str.empty())
+				return ExtractError::EmptyValue;
+			if (layout.empty())
+				layout = DefaultTimestampLayout();
+
+			unsigned parts[6] = { 1970, 1, 1, 0, 0, 0 };
+			uint32_t nanoseconds = 0;
+			size_t pos = 0;
+			for (size_t i = 0; i < layout.size; ++i)
+			{
+				if (pos == str.size && i + 3 == layout.size && layout[i + 1] == '%' && layout[i + 2] == 'f')
+					break;
+
+				// '%' for a character matched as it is, %% included
+				const char code = (layout[i] == '%' && i + 1 < layout.size) ? layout[++i] : '%';
+				if (code == '%')
+				{
+					if (pos == str.size || str[pos] != layout[i])
+						return ExtractError::InvalidValue;
+					++pos;
+					continue;
+				}
+
+				if (code == 'f')
+				{
+					size_t digits = 0;
+					while (pos < str.size && digits < 9 && IsDigit(str[pos]))
+					{
+						nanoseconds = nanoseconds * 10 + static_cast<uint32_t>(str[pos] - '0');
+						++pos;
+						++digits;
+					}
+					if (digits == 0)
+						return ExtractError::InvalidValue;
+					for (; digits < 9; ++digits)
+						nanoseconds *= 10;
+					continue;
+				}
+
+				const size_t width = (code == 'Y') ? 4 : 2;
+				if (str.size - pos < width)
+					return ExtractError::InvalidValue;
+				unsigned number = 0;
+				for (size_t end = pos + width; pos < end; ++pos)
+				{
+					if (IsDigit(str[pos]) == false)
+						return ExtractError::InvalidValue;
+					number = number * 10 + static_cast<unsigned>(str[pos] - '0');
+				}
+
+				switch (code)
+				{
+				case 'Y': parts[0] = number; break;
+				case 'm': parts[1] = number; break;
+				case 'd': parts[2] = number; break;
+				case 'H': parts[3] = number; break;
+				case 'M': parts[4] = number; break;
+				default: parts[5] = number; break;
+				}
+			}
+			if (pos != str.size)
+				return ExtractError::TrailingChars;
+
+			if (parts[1] < 1 || parts[1] > 12 || parts[2] < 1 || parts[2] > DaysInMonth(parts[0], parts[1]) ||
+				parts[3] > 23 || parts[4] > 59 || parts[5] > 59)
+				return ExtractError::OutOfRange;
+
+			const int64_t seconds = ((DaysFromCivil(parts[0], parts[1], parts[2]) * 24 + parts[3]) * 60 + parts[4]) * 60 + parts[5];
+			// the range of int64_t nanoseconds, 1677 to 2262
+			if (seconds < -9223372036LL || seconds > 9223372035LL)
+				return ExtractError::OutOfRange;
+			value = seconds * 1000000000 + nanoseconds;
+			return ExtractError::None;
+		}
+
+		// A {ts} field converts into epoch nanoseconds or a time_point, any
+		// other field like ConvertTo does
+		template<typename T>
+		ExtractError ConvertField(StringView str, TokenType tokenType, StringView, T& value)
+		{
+			return ConvertTo(str, tokenType, value);
+		}
+
+		inline ExtractError ConvertField(StringView str, TokenType tokenType, StringView layout, int64_t& value)
+		{
+			if (tokenType == TokenType::Timestamp)
+				return ParseTimestamp(str, layout, value);
+			return ConvertTo(str, tokenType, value);
+		}
+
+		template<typename Duration>
+		ExtractError ConvertField(StringView str, TokenType, StringView layout, std::chrono::time_point<std::chrono::system_clock, Duration>& value)
+		{
+			int64_t nanoseconds = 0;
+			const ExtractError error = ParseTimestamp(str, layout, nanoseconds);
+			if (error == ExtractError::None)
+			{
+				const std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> time{ std::chrono::nanoseconds(nanoseconds) };
+				value = std::chrono::time_point_cast<Duration>(time);
+			}
+			return error;
+		}
+
+		// {} into a time_point has the default layout
+		template<typename Duration>
+		ExtractError ConvertTo(StringView str, TokenType tokenType, std::chrono::time_point<std::chrono::system_clock, Duration>& value)
+		{
+			return ConvertField(str, tokenType, StringView(), value);
+		}
+	}
+
+	namespace detail
+	{
+		struct Specifier
+		{
+			const char* text;
+			TokenType type;
+		};
+
+		// Specifiers recognised by TokenizeFmtString, by the text between the
+		// braces. New specifiers are added to this table; the tokenizer still
+		// makes a single pass over the format string.
+		template<typename T = void>
+		struct SpecifierTable
+		{
+			static constexpr Specifier entries[] =
+			{
+				{ "", TokenType::Matter },
+				{ "h", TokenType::Hex },
+				{ "x", TokenType::None },
+				{ "t", TokenType::Trim },
+				{ "d", TokenType::Digits },
+				{ "w", TokenType::Word },
+				{ "a", TokenType::Alnum },
+				{ "ts", TokenType::Timestamp },
+				{ "ip", TokenType::Ipv4 },
+				{ "ip6", TokenType::Ipv6 },
+				{ "mac", TokenType::Mac }
+			};
+		};
+
+		template<typename T>
+		constexpr Specifier SpecifierTable<T>::entries[];
+
+		// The text between the braces of a specifier
+		inline const char* SpecifierText(TokenType type)
+		{
+			for (const Specifier& spec : SpecifierTable<>::entries)
+			{
+				if (spec.type == type)
+					return spec.text;
+			}
+			return "";
+		}
+	}
+
+	// Counters of one format, summed over the threads by CollectFormatStats.
+	// They are only counted when VALUES_ENABLE_STATS is defined.
+	struct FormatStats
+	{
+		// the fmt rebuilt from its literals and fields, without the anchors
+		std::string fmt;
+		uint64_t calls;
+		uint64_t matches;
+		uint64_t misses;
+		// misses by index of the token whose delimiter was not found
+		std::vector<uint64_t> missesByToken;
+		uint64_t conversionErrors;
+		// size of the inputs
+		uint64_t bytesScanned;
+		uint64_t nanoseconds;
+		// as counted by the function given to SetStatsAllocationCounter
+		uint64_t allocations;
+	};
+
+	typedef size_t (*StatsAllocationCounter)();
+
+#ifdef VALUES_ENABLE_STATS
+	namespace detail
+	{
+		// Counters of one format in one thread. Only that thread writes
+		// them, so a relaxed load and store is enough, and they can be read
+		// by the thread which merges them at any time.
+		struct StatsCounters
+		{
+			StatsCounters(const std::string& fmt_, size_t tokens_)
+				: fmt(fmt_)
+				, tokens(tokens_)
+				, calls(0)
+				, matches(0)
+				, misses(0)
+				, conversionErrors(0)
+				, bytesScanned(0)
+				, nanoseconds(0)
+				, allocations(0)
+				, missesByToken(new std::atomic<uint64_t>[tokens_ > 0 ? tokens_ : 1])
+			{
+				for (size_t i = 0; i < tokens; ++i)
+					missesByToken[i].store(0, std::memory_order_relaxed);
+			}
+
+			std::string fmt;
+			size_t tokens;
+			std::atomic<uint64_t> calls;
+			std::atomic<uint64_t> matches;
+			std::atomic<uint64_t> misses;
+			std::atomic<uint64_t> conversionErrors;
+			std::atomic<uint64_t> bytesScanned;
+			std::atomic<uint64_t> nanoseconds;
+			std::atomic<uint64_t> allocations;
+			std::unique_ptr<std::atomic<uint64_t>[]> missesByToken;
+		};
+
+		inline void Bump(std::atomic<uint64_t>& counter, uint64_t value = 1)
+		{
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		inline uint64_t Read(const std::atomic<uint64_t>& counter)
+		{
+			return counter.load(std::memory_order_relaxed);
+		}
+
+		inline void MergeStats(FormatStats& stats, const StatsCounters& counters)
+		{
+			stats.fmt = counters.fmt;
+			stats.calls += Read(counters.calls);
+			stats.matches += Read(counters.matches);
+			stats.misses += Read(counters.misses);
+			stats.conversionErrors += Read(counters.conversionErrors);
+			stats.bytesScanned += Read(counters.bytesScanned);
+			stats.nanoseconds += Read(counters.nanoseconds);
+			stats.allocations += Read(counters.allocations);
+			if (stats.missesByToken.size() < counters.tokens)
+				stats.missesByToken.resize(counters.tokens, 0);
+			for (size_t i = 0; i < counters.tokens; ++i)
+				stats.missesByToken[i] += Read(counters.missesByToken[i]);
+		}
+
+		class ThreadStats;
+
+		// The threads which count, and the counters of those which exited
+		struct StatsRegistry
+		{
+			std::mutex mutex;
+			std::vector<ThreadStats*> threads;
+			std::map<uint64_t, FormatStats> retired;
+		};
+
+		inline StatsRegistry& GlobalStatsRegistry()
+		{
+			static StatsRegistry registry;
+			return registry;
+		}
+
+		inline std::atomic<StatsAllocationCounter>& AllocationCounter()
+		{
+			static std::atomic<StatsAllocationCounter> counter(nullptr);
+			return counter;
+		}
+
+		inline size_t AllocationCount()
+		{
+			StatsAllocationCounter counter = AllocationCounter().load(std::memory_order_relaxed);
+			return counter ? counter() : 0;
+		}
+
+		// The formats seen by one thread. The map is locked when the thread
+		// adds a format and when the counters are merged; the counters
+		// themselves are not.
+		class ThreadStats
+		{
+		public:
+			ThreadStats()
+			{
+				StatsRegistry& registry = GlobalStatsRegistry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				registry.threads.push_back(this);
+			}
+
+			~ThreadStats()
+			{
+				StatsRegistry& registry = GlobalStatsRegistry();
+				std::lock_guard<std::mutex> lock(registry.mutex);
+				MergeInto(registry.retired);
+				registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(), this));
+			}
+
+			ThreadStats(const ThreadStats&) = delete;
+			ThreadStats& operator=(const ThreadStats&) = delete;
+
+			template<typename Format>
+			StatsCounters& Get(const Format& format)
+			{
+				const uint64_t key = StatsKey(format);
+				auto it = m_formats.find(key);
+				if (it != m_formats.end())
+					return *it->second;
+
+				std::unique_ptr<StatsCounters> counters(new StatsCounters(StatsText(format), format.Fields()));
+				std::lock_guard<std::mutex> lock(m_mutex);
+				return *(m_formats[key] = std::move(counters));
+			}
+
+			void MergeInto(std::map<uint64_t, FormatStats>& all)
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				for (const auto& entry : m_formats)
+					MergeStats(all[entry.first], *entry.second);
+			}
+
+			void Reset()
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				for (const auto& entry : m_formats)
+				{
+					StatsCounters& counters = *entry.second;
+					std::atomic<uint64_t>* all[] = { &counters.calls, &counters.matches, &counters.misses,
+						&counters.conversionErrors, &counters.bytesScanned, &counters.nanoseconds, &counters.allocations };
+					for (std::atomic<uint64_t>* counter : all)
+						counter->store(0, std::memory_order_relaxed);
+					for (size_t i = 0; i < counters.tokens; ++i)
+						counters.missesByToken[i].store(0, std::memory_order_relaxed);
+				}
+			}
+
+		private:
+			// FNV-1a of the literals and of the fields between them, so the
+			// same fmt gets the same counters whether it is used as tokens or
+			// as a CompiledFormat
+			template<typename Format>
+			static uint64_t StatsKey(const Format& format)
+			{
+				uint64_t hash = 14695981039346656037ULL;
+				for (size_t i = 0; i <= format.Fields(); ++i)
+				{
+					for (char ch : format.Literal(i))
+					{
+						hash ^= static_cast<unsigned char>(ch);
+						hash *= 1099511628211ULL;
+					}
+					if (i < format.Fields())
+					{
+						hash ^= (static_cast<uint64_t>(format.FieldType(i)) + 1) << 56 | format.FieldWidth(i);
+						hash *= 1099511628211ULL;
+						for (char ch : format.FieldArg(i))
+						{
+							hash ^= static_cast<unsigned char>(ch);
+							hash *= 1099511628211ULL;
+						}
+					}
+				}
+				return hash;
+			}
+
+			template<typename Format>
+			static std::string StatsText(const Format& format)
+			{
+				std::string text;
+				for (size_t i = 0; i <= format.Fields(); ++i)
+				{
+					const StringView literal = format.Literal(i);
+					text.append(literal.data, literal.size);
+					if (i < format.Fields())
+					{
+						text += '{';
+						if (format.FieldWidth(i) != 0)
+							text += std::to_string(format.FieldWidth(i));
+						text += SpecifierText(format.FieldType(i));
+						const StringView arg = format.FieldArg(i);
+						if (arg.empty() == false)
+							(text += ':').append(arg.data, arg.size);
+						text += '}';
+					}
+				}
+				return text;
+			}
+
+			std::mutex m_mutex;
+			std::unordered_map<uint64_t, std::unique_ptr<StatsCounters>> m_formats;
+		};
+
+		inline ThreadStats& CurrentThreadStats()
+		{
+			static thread_local ThreadStats stats;
+			return stats;
+		}
+
+		// Counts one call of a format: the time and the allocations until
+		// it is destroyed, and the outcome. The conversions made meanwhile
+		// report their errors to the innermost scope of the thread.
+		class StatsScope
+		{
+		public:
+			template<typename Format>
+			StatsScope(const Format& format, StringView input)
+				: m_counters(CurrentThreadStats().Get(format))
+				, m_previous(Current())
+				, m_allocations(AllocationCount())
+				, m_begin(std::chrono::steady_clock::now())
+			{
+				Bump(m_counters.calls);
+				Bump(m_counters.bytesScanned, input.size);
+				Current() = this;
+			}
+
+			~StatsScope()
+			{
+				const auto elapsed = std::chrono::steady_clock::now() - m_begin;
+				Bump(m_counters.nanoseconds, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+				Bump(m_counters.allocations, AllocationCount() - m_allocations);
+				Current() = m_previous;
+			}
+
+			StatsScope(const StatsScope&) = delete;
+			StatsScope& operator=(const StatsScope&) = delete;
+
+			void Match()
+			{
+				Bump(m_counters.matches);
+			}
+
+			void Miss(size_t token)
+			{
+				Bump(m_counters.misses);
+				if (token < m_counters.tokens)
+					Bump(m_counters.missesByToken[token]);
+			}
+
+			void ConversionError()
+			{
+				Bump(m_counters.conversionErrors);
+			}
+
+			// Outcome of an extraction over the whole format
+			void Done(const ExtractResult& result)
+			{
+				if (result.error == ExtractError::PrefixNotFound || result.error == ExtractError::PostfixNotFound)
+					Miss(static_cast<size_t>(result.token));
+				else if (result.error != ExtractError::ArgCountMismatch)
+				{
+					Match();
+					if (result.error != ExtractError::None)
+						ConversionError();
+				}
+			}
+
+			static StatsScope*& Current()
+			{
+				static thread_local StatsScope* scope = nullptr;
+				return scope;
+			}
+
+		private:
+			StatsCounters& m_counters;
+			StatsScope* m_previous;
+			size_t m_allocations;
+			std::chrono::steady_clock::time_point m_begin;
+		};
+
+		inline void StatsConversionError()
+		{
+			if (StatsScope* scope = StatsScope::Current())
+				scope->ConversionError();
+		}
+	}
+
+	// Sets the function which returns the number of allocations made so far
+	// by the process, e.g. counted by a replaced operator new
+	inline void SetStatsAllocationCounter(StatsAllocationCounter counter)
+	{
+		detail::AllocationCounter().store(counter, std::memory_order_relaxed);
+	}
+
+	// Merges the counters of every thread, including those which exited
+	inline std::vector<FormatStats> CollectFormatStats()
+	{
+		detail::StatsRegistry& registry = detail::GlobalStatsRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		std::map<uint64_t, FormatStats> all = registry.retired;
+		for (detail::ThreadStats* thread : registry.threads)
+			thread->MergeInto(all);
+
+		std::vector<FormatStats> stats;
+		stats.reserve(all.size());
+		for (auto& entry : all)
+			stats.push_back(std::move(entry.second));
+		return stats;
+	}
+
+	// The counters being bumped meanwhile by other threads may be missed
+	inline void ResetFormatStats()
+	{
+		detail::StatsRegistry& registry = detail::GlobalStatsRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		registry.retired.clear();
+		for (detail::ThreadStats* thread : registry.threads)
+			thread->Reset();
+	}
+#else
+	namespace detail
+	{
+		// Compiled out: every call is inlined away
+		class StatsScope
+		{
+		public:
+			template<typename Format>
+			StatsScope(const Format&, StringView) {}
+
+			void Match() {}
+
+			void Miss(size_t) {}
+
+			void ConversionError() {}
+
+			void Done(const ExtractResult&) {}
+		};
+
+		inline void StatsConversionError() {}
+	}
+
+	inline void SetStatsAllocationCounter(StatsAllocationCounter) {}
+
+	inline std::vector<FormatStats> CollectFormatStats()
+	{
+		return std::vector<FormatStats>();
+	}
+
+	inline void ResetFormatStats() {}
+#endif
+
+	namespace detail
+	{
+		// Tokens seen as a format by StatsScope, like a CompiledFormat
+		class TokensView
+		{
+		public:
+			explicit TokensView(const std::vector<Token>& tokens) : m_tokens(tokens) {}
+
+			size_t Fields() const { return m_tokens.size(); }
+
+			StringView Literal(size_t index) const
+			{
+				if (index < m_tokens.size())
+					return m_tokens[index].prefix;
+				return m_tokens.empty() ? StringView() : StringView(m_tokens.back().postfix);
+			}
+
+			TokenType FieldType(size_t index) const { return m_tokens[index].type; }
+
+			size_t FieldWidth(size_t index) const { return m_tokens[index].width; }
+
+			StringView FieldArg(size_t index) const
+			{
+				const Token& token = m_tokens[index];
+				return (token.type == TokenType::Timestamp) ? StringView(token.layout) : StringView(token.trimChars);
+			}
+
+		private:
+			const std::vector<Token>& m_tokens;
+		};
+	}
+
+	class DataTypeRef
+	{
+	public:
+		~DataTypeRef() {}
+
+		union UNIONPTR
+		{
+			int32_t* pi;
+			uint32_t* pui;
+			int16_t* psi;
+			uint16_t* pusi;
+			int64_t* pi64;
+			uint64_t* pui64;
+			float* pf;
+			double* pd;
+			std::string* ps;
+			std::wstring* pws;
+			std::u16string* pu16s;
+			std::u32string* pu32s;
+			char* pc;
+			unsigned char* puc;
+			wchar_t* pwc;
+			StringView* psv;
+			ArenaString* pas;
+			std::chrono::system_clock::time_point* ptp;
+			std::array<uint8_t, 16>* pip6;
+			std::array<uint8_t, 6>* pmac;
+		};
+
+		enum DTR_TYPE
+		{
+			DTR_INT,
+			DTR_UINT,
+			DTR_SHORT,
+			DTR_USHORT,
+			DTR_INT64,
+			DTR_UINT64,
+			DTR_FLOAT,
+			DTR_DOUBLE,
+			DTR_STR,
+			DTR_WSTR,
+			DTR_CHAR,
+			DTR_UCHAR,
+			DTR_WCHAR,
+			DTR_STRVIEW,
+			DTR_ARENASTR,
+			DTR_U16STR,
+			DTR_U32STR,
+			DTR_TIMEPOINT,
+			DTR_IPV6,
+			DTR_MAC
+		};
+
+		DataTypeRef(int32_t& i) { m_ptr.pi = &i; m_type = DTR_INT; }
+
+		DataTypeRef(uint32_t& ui) { m_ptr.pui = &ui; m_type = DTR_UINT; }
+
+		DataTypeRef(int16_t& si) { m_ptr.psi = &si; m_type = DTR_SHORT; }
+
+		DataTypeRef(uint16_t& usi) { m_ptr.pusi = &usi; m_type = DTR_USHORT; }
+
+		DataTypeRef(int64_t& i64) { m_ptr.pi64 = &i64; m_type = DTR_INT64; }
+
+		DataTypeRef(uint64_t& ui64) { m_ptr.pui64 = &ui64; m_type = DTR_UINT64; }
+
+		DataTypeRef(float& f) { m_ptr.pf = &f; m_type = DTR_FLOAT; }
+
+		DataTypeRef(double& d) { m_ptr.pd = &d; m_type = DTR_DOUBLE; }
+
+		DataTypeRef(std::string& s) { m_ptr.ps = &s; m_type = DTR_STR; }
+
+		// The wide strings are decoded from UTF-8
+		DataTypeRef(std::wstring& ws) { m_ptr.pws = &ws; m_type = DTR_WSTR; }
+
+		DataTypeRef(std::u16string& u16s) { m_ptr.pu16s = &u16s; m_type = DTR_U16STR; }
+
+		DataTypeRef(std::u32string& u32s) { m_ptr.pu32s = &u32s; m_type = DTR_U32STR; }
+
+		DataTypeRef(char& c) { m_ptr.pc = &c; m_type = DTR_CHAR; }
+
+		DataTypeRef(unsigned char& uc) { m_ptr.puc = &uc; m_type = DTR_UCHAR; }
+
+		DataTypeRef(wchar_t& wc) { m_ptr.pwc = &wc; m_type = DTR_WCHAR; }
+
+		// The view points into the input given to ValuesExtract, so it is only
+		// valid as long as the input buffer is alive and unmodified.
+		DataTypeRef(StringView& sv) { m_ptr.psv = &sv; m_type = DTR_STRVIEW; }
+
+		DataTypeRef(ArenaString& as) { m_ptr.pas = &as; m_type = DTR_ARENASTR; }
+
+		// Parsed from a {ts} field, or from a {} field of the default layout
+		DataTypeRef(std::chrono::system_clock::time_point& tp) { m_ptr.ptp = &tp; m_type = DTR_TIMEPOINT; }
+
+		// An IPv6 address in network order; an {ip} field goes to a uint32_t
+		DataTypeRef(std::array<uint8_t, 16>& ip6) { m_ptr.pip6 = &ip6; m_type = DTR_IPV6; }
+
+		DataTypeRef(std::array<uint8_t, 6>& mac) { m_ptr.pmac = &mac; m_type = DTR_MAC; }
+
+		static std::string TrimRight(const std::string& str, const std::string& trimChars)
+		{
+			std::string result = "";
+			// trim trailing spaces
+			size_t endpos = str.find_last_not_of(trimChars);
+			if (std::string::npos != endpos)
+			{
+				result = str.substr(0, endpos + 1);
+			}
+			else
+				result = str;
+
+			return result;
+		}
+
+		static std::string TrimLeft(const std::string& str, const std::string& trimChars)
+		{
+			std::string result = "";
+
+			// trim leading spaces
+			size_t startpos = str.find_first_not_of(trimChars);
+			if (std::string::npos != startpos)
+			{
+				result = str.substr(startpos);
+			}
+			else
+				result = str;
+
+			return result;
+		}
+
+		// Same as the trimming of a {t} field: one copy of the trimmed bounds
+		static std::string Trim(const std::string& str, const std::string& trimChars)
+		{
+			return detail::TrimView(str, trimChars).ToString();
+		}
+
+		bool ConvStrToType(StringView str, TokenType tokenType, StringView layout = StringView())
+		{
+			const ExtractError error = Convert(str, tokenType, layout);
+			if (error != ExtractError::None)
+				detail::StatsConversionError();
+			return detail::ThrowIfEmpty(error) == ExtractError::None;
+		}
+
+		// layout is the one of a {ts} field
+		ExtractError Convert(StringView str, TokenType tokenType, StringView layout = StringView())
+		{
+			switch (m_type)
+			{
+			case DTR_INT:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pi));
+			case DTR_UINT:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pui));
+			case DTR_SHORT:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.psi));
+			case DTR_USHORT:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pusi));
+			case DTR_INT64:
+				return detail::ConvertField(str, tokenType, layout, *(m_ptr.pi64));
+			case DTR_UINT64:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pui64));
+			case DTR_FLOAT:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pf));
+			case DTR_DOUBLE:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pd));
+			case DTR_STR:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.ps));
+			case DTR_WSTR:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pws));
+			case DTR_CHAR:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pc));
+			case DTR_UCHAR:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.puc));
+			case DTR_WCHAR:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pwc));
+			case DTR_STRVIEW:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.psv));
+			case DTR_ARENASTR:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pas));
+			case DTR_U16STR:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pu16s));
+			case DTR_U32STR:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pu32s));
+			case DTR_TIMEPOINT:
+				return detail::ConvertField(str, tokenType, layout, *(m_ptr.ptp));
+			case DTR_IPV6:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pip6));
+			case DTR_MAC:
+				return detail::ConvertTo(str, tokenType, *(m_ptr.pmac));
+			default:
+				return ExtractError::InvalidValue;
+			}
+
+			return ExtractError::InvalidValue;
+		}
+
+		DTR_TYPE m_type;
+
+		UNIONPTR m_ptr;
+	};
+
+	namespace detail
+	{
+		// Returns the index of the specifier in the table, -1 if unknown. An
+		// index rather than a pointer, as comparing the address of the table
+		// to nullptr is not a constant expression with some sanitizers.
+		VALUES_CONSTEXPR14 int FindSpecifier(const char* text, size_t len)
+		{
+			const int count = static_cast<int>(sizeof(SpecifierTable<>::entries) / sizeof(SpecifierTable<>::entries[0]));
+			for (int index = 0; index < count; ++index)
+			{
+				const Specifier& spec = SpecifierTable<>::entries[index];
+				size_t i = 0;
+				while (i < len && spec.text[i] == text[i])
+					++i;
+				if (i == len && spec.text[i] == '\0')
+					return index;
+			}
+			return -1;
+		}
+
+		// Appends the digit to value unless it overflows
+		VALUES_CONSTEXPR14 bool AppendDigit(size_t& value, char digit)
+		{
+			const size_t d = static_cast<size_t>(digit - '0');
+			if (value > (std::numeric_limits<size_t>::max() - d) / 10)
+				return false;
+			value = value * 10 + d;
+			return true;
+		}
+
+		// Reads {^}, {$} and {@N}, the text between the braces. An N which
+		// overflows size_t is not an anchor.
+		VALUES_CONSTEXPR14 bool ParseAnchor(const char* text, size_t len, Anchor& anchor)
+		{
+			if (len == 1 && (text[0] == '^' || text[0] == '$'))
+			{
+				anchor = Anchor(text[0] == '^' ? AnchorKind::Offset : AnchorKind::End, 0);
+				return true;
+			}
+			if (len < 2 || text[0] != '@')
+				return false;
+
+			size_t offset = 0;
+			for (size_t i = 1; i < len; ++i)
+			{
+				if (text[i] < '0' || text[i] > '9' || AppendDigit(offset, text[i]) == false)
+					return false;
+			}
+			anchor = Anchor(AnchorKind::Offset, offset);
+			return true;
+		}
+
+		// Reads the width of {N}, {Nh}, {Nt} and {Nx}. Returns the number of
+		// digits, which are followed by the specifier. A width which
+		// overflows size_t is read as 0, which is not a specifier like {0}.
+		VALUES_CONSTEXPR14 size_t ParseWidth(const char* text, size_t len, size_t& width)
+		{
+			size_t i = 0;
+			width = 0;
+			bool overflow = false;
+			while (i < len && text[i] >= '0' && text[i] <= '9')
+			{
+				if (AppendDigit(width, text[i]) == false)
+					overflow = true;
+				++i;
+			}
+			if (overflow)
+				width = 0;
+			return i;
+		}
+
+		// Reads the specifier after the width, and its argument after a
+		// colon: the characters to trim in {t:chars}, e.g. {t: "} trims the
+		// spaces and the quotes, or the layout in {ts:layout}. Returns the
+		// index of the specifier, -1 if unknown; argPos and argLen locate the
+		// argument in text.
+		VALUES_CONSTEXPR14 int ParseSpecifier(const char* text, size_t len, size_t& argPos, size_t& argLen)
+		{
+			size_t colon = 0;
+			while (colon < len && text[colon] != ':')
+				++colon;
+
+			argPos = 0;
+			argLen = 0;
+			const int spec = FindSpecifier(text, colon);
+			if (spec < 0 || colon == len)
+				return spec;
+			const TokenType type = SpecifierTable<>::entries[spec].type;
+			if ((type != TokenType::Trim && type != TokenType::Timestamp) || colon + 1 == len)
+				return -1;
+			if (type == TokenType::Timestamp && IsTimestampLayout(text + colon + 1, len - colon - 1) == false)
+				return -1;
+
+			argPos = colon + 1;
+			argLen = len - argPos;
+			return spec;
+		}
+	}
+
+	inline std::vector<Token> TokenizeFmtString(const std::string& fmt)
+	{
+		std::vector<Token> vec;
+
+		int index = 0;
+		size_t literal_start = 0;
+		size_t literal_end = fmt.size();
+		detail::Anchor anchor; // of the literal from literal_start
+		size_t pos = fmt.find('{');
+		while (pos != std::string::npos)
+		{
+			size_t close = fmt.find('}', pos + 1);
+			if (close == std::string::npos)
+				break;
+
+			detail::Anchor marker;
+			if (detail::ParseAnchor(fmt.data() + pos + 1, close - pos - 1, marker))
+			{
+				const bool atEnd = (marker.kind == detail::AnchorKind::End);
+				const bool atStart = (fmt[pos + 1] == '^');
+				if (anchor.Anchored() || (atEnd ? close + 1 != fmt.size() : literal_start != pos) || (atStart && pos != 0))
+				{
+					std::cerr << "Error: Anchor {^} must start the fmt, {@N} a literal and {$} must end the fmt!\n";
+					return {};
+				}
+				anchor = marker;
+				if (atEnd)
+				{
+					literal_end = pos;
+					break;
+				}
+				literal_start = close + 1;
+				pos = fmt.find('{', literal_start);
+				continue;
+			}
+
+			size_t width = 0;
+			size_t argPos = 0;
+			size_t argLen = 0;
+			const size_t digits = detail::ParseWidth(fmt.data() + pos + 1, close - pos - 1, width);
+			const int spec = (digits == 0 || width != 0) ?
+				detail::ParseSpecifier(fmt.data() + pos + 1 + digits, close - pos - 1 - digits, argPos, argLen) : -1;
+			if (spec < 0)
+			{
+				pos = fmt.find('{', pos + 1);
+				continue;
+			}
+
+			Token curr;
+			curr.index = -1;
+			curr.start = pos;
+			curr.size = close - pos + 1;
+			curr.width = width;
+			curr.type = detail::SpecifierTable<>::entries[spec].type;
+			if (curr.type == TokenType::Timestamp)
+				curr.layout = fmt.substr(pos + 1 + digits + argPos, argLen);
+			else
+				curr.trimChars = fmt.substr(pos + 1 + digits + argPos, argLen);
+			if (curr.type != TokenType::None)
+			{
+				curr.index = index;
+				++index;
+			}
+
+			if (vec.empty() == false)
+			{
+				// unless an anchor or a width tells where one field ends and
+				// the next starts
+				if (literal_start == pos && anchor.Anchored() == false && vec.back().width == 0 &&
+					detail::FieldClass(vec.back().type) == 0 && vec.back().type != TokenType::Timestamp)
+				{
+					std::cerr << "Error: Format specifier {} cannot be side by side! For example: {}{}\n";
+					return {};
+				}
+				vec.back().postfix = fmt.substr(literal_start, pos - literal_start);
+				vec.back().postfixAnchor = anchor;
+			}
+			curr.prefix = fmt.substr(literal_start, pos - literal_start);
+			curr.prefixAnchor = anchor;
+			vec.push_back(std::move(curr));
+
+			anchor = detail::Anchor();
+			literal_start = close + 1;
+			pos = fmt.find('{', literal_start);
+		}
+
+		if (vec.empty() == false)
+		{
+			vec.back().postfix = fmt.substr(literal_start, literal_end - literal_start);
+			vec.back().postfixAnchor = anchor;
+		}
+
+		for (auto& token : vec)
+		{
+			token.prefixSearcher = detail::MakeSearcher(token.prefix);
+			token.postfixSearcher = detail::MakeSearcher(token.postfix);
+		}
+
+		return vec;
+	}
+	namespace detail
+	{
+
+		inline void AddData(std::vector<DataTypeRef>& /*results*/)
+		{
+		}
+
+
+		template<typename T, typename... Args>
+		void AddData(std::vector<DataTypeRef>& results, T& value, Args & ... args)
+		{
+			results.push_back({ value });
+			AddData(results, args...);
+		}
+
+		inline size_t CountArgs(const std::vector<Token>& tokens)
+		{
+			size_t count = 0;
+			for (const auto& token : tokens)
+			{
+				if (token.type != TokenType::None)
+					++count;
+			}
+			return count;
+		}
+
+		inline void PrintScanError(ExtractError error)
+		{
+			if (error == ExtractError::PrefixNotFound)
+				std::cerr << "prefix_pos Error\n";
+			else if (error == ExtractError::PostfixNotFound)
+				std::cerr << "postfix_pos Error\n";
+		}
+
+		inline void ValuesExtractHelp(StringView input, const std::vector<Token>& tokens, std::vector<DataTypeRef>& results)
+		{
+			if (results.size() != CountArgs(tokens))
+			{
+				std::cerr << "Number of parameters and fmt token mismatched\n";
+				return;
+			}
+
+			StatsScope stats(TokensView(tokens), input);
+			size_t pos = 0;
+			for (size_t i = 0; i < tokens.size(); ++i)
+			{
+				auto& curr = tokens[i];
+
+				StringView res;
+				ExtractError error = FindField(input, curr, pos, res);
+				if (error != ExtractError::None)
+				{
+					stats.Miss(i);
+					PrintScanError(error);
+					return;
+				}
+
+				if (curr.index != -1)
+				{
+					results.at(curr.index).ConvStrToType(res, curr.type, curr.layout);
+				}
+			}
+			stats.Match();
+		}
+
+		// Walks the tokens over the input and hands out the fields which are
+		// extracted into a parameter; the {x} fields are skipped over.
+		class FieldScanner
+		{
+		public:
+			FieldScanner(StringView input, const std::vector<Token>& tokens)
+				: m_input(input)
+				, m_tokens(tokens)
+				, m_index(0)
+				, m_pos(0)
+			{
+			}
+
+			// layout is the one of a {ts} field
+			ExtractError Next(StringView& field, TokenType& type, StringView& layout)
+			{
+				while (m_index < m_tokens.size())
+				{
+					const Token& curr = m_tokens[m_index++];
+
+					ExtractError error = FindField(m_input, curr, m_pos, field);
+					if (error != ExtractError::None)
+						return error;
+
+					if (curr.type != TokenType::None)
+					{
+						type = curr.type;
+						layout = curr.layout;
+						return ExtractError::None;
+					}
+				}
+				return ExtractError::None;
+			}
+
+			// Scans the {x} fields after the last parameter
+			ExtractError Finish()
+			{
+				StringView field;
+				TokenType type;
+				StringView layout;
+				return Next(field, type, layout);
+			}
+
+			// Failure of the token returned or scanned last, at offset
+			ExtractResult Fail(ExtractError error, size_t offset) const
+			{
+				ExtractResult result = { error, static_cast<int32_t>(m_index) - 1, offset };
+				return result;
+			}
+
+			ExtractResult Fail(ExtractError error) const
+			{
+				return Fail(error, m_pos);
+			}
+
+			size_t Offset(StringView field) const
+			{
+				return static_cast<size_t>(field.data - m_input.data);
+			}
+
+		private:
+			StringView m_input;
+			const std::vector<Token>& m_tokens;
+			size_t m_index;
+			size_t m_pos;
+		};
+
+		inline ExtractResult Success()
+		{
+			ExtractResult result = { ExtractError::None, -1, 0 };
+			return result;
+		}
+
+		template<bool Checked, typename Scanner>
+		ExtractResult ExtractArgs(Scanner& scanner)
+		{
+			ExtractError error = scanner.Finish();
+			return (error == ExtractError::None) ? Success() : scanner.Fail(error);
+		}
+
+		// Converts each field straight into its parameter: the overload of
+		// ConvertTo is chosen at compile time and nothing is allocated.
+		// Checked stops at the first conversion error; unchecked throws on
+		// an empty value and ignores the other conversion errors.
+		template<bool Checked, typename Scanner, typename T, typename... Args>
+		ExtractResult ExtractArgs(Scanner& scanner, T& value, Args & ... args)
+		{
+			StringView field;
+			TokenType type = TokenType::Matter;
+			StringView layout;
+			ExtractError error = scanner.Next(field, type, layout);
+			if (error != ExtractError::None)
+				return scanner.Fail(error);
+
+			error = ConvertField(field, type, layout, value);
+			if (Checked)
+			{
+				if (error != ExtractError::None)
+					return scanner.Fail(error, scanner.Offset(field));
+			}
+			else
+				ThrowIfEmpty(error);
+
+			return ExtractArgs<Checked>(scanner, args...);
+		}
+
+		inline ExtractResult ArgCountMismatch()
+		{
+			ExtractResult result = { ExtractError::ArgCountMismatch, -1, 0 };
+			return result;
+		}
+	}
+
+	template<typename... Args>
+	void ValuesExtract(StringView input, const std::vector<Token>& tokens, Args & ... args)
+	{
+		if (detail::CountArgs(tokens) != sizeof...(Args))
+		{
+			std::cerr << "Number of parameters and fmt token mismatched\n";
+			return;
+		}
+
+		detail::StatsScope stats(detail::TokensView(tokens), input);
+		detail::FieldScanner scanner(input, tokens);
+
+		ExtractResult result = detail::ExtractArgs<false>(scanner, args...);
+		stats.Done(result);
+		detail::PrintScanError(result.error);
+	}
+
+	// Same as ValuesExtract but reports the failure instead of printing it:
+	// nothing is written to stderr and nothing is thrown. Extraction stops at
+	// the first failure; the parameters before it hold their values and a
+	// parameter whose value is out of range is left unchanged.
+	template<typename... Args>
+	ExtractResult ValuesExtractChecked(StringView input, const std::vector<Token>& tokens, Args & ... args)
+	{
+		if (detail::CountArgs(tokens) != sizeof...(Args))
+			return detail::ArgCountMismatch();
+
+		detail::StatsScope stats(detail::TokensView(tokens), input);
+		detail::FieldScanner scanner(input, tokens);
+
+		ExtractResult result = detail::ExtractArgs<true>(scanner, args...);
+		stats.Done(result);
+		return result;
+	}
+
+	namespace detail
+	{
+		// What a value is converted into before it is stored: the value
+		// itself for the types whose conversion can fail (the wide strings
+		// included, as the UTF-8 can be invalid), the field for the other
+		// strings, which are converted straight into the parameter.
+		template<typename T>
+		struct Staging
+		{
+			typedef T type;
+
+			static bool Stage(StringView field, TokenType tokenType, StringView layout, T& staged)
+			{
+				return ConvertField(field, tokenType, layout, staged) == ExtractError::None;
+			}
+			static void Commit(T& staged, StringView, TokenType, T& value)
+			{
+				value = std::move(staged);
+			}
+		};
+
+		template<typename T>
+		struct StringStaging
+		{
+			typedef StringView type;
+
+			static bool Stage(StringView, TokenType, StringView, StringView&)
+			{
+				return true;
+			}
+			static void Commit(StringView, StringView field, TokenType tokenType, T& value)
+			{
+				ConvertTo(field, tokenType, value);
+			}
+		};
+
+		template<typename Traits, typename Alloc>
+		struct Staging<std::basic_string<char, Traits, Alloc>> : StringStaging<std::basic_string<char, Traits, Alloc>> {};
+		template<> struct Staging<ArenaString> : StringStaging<ArenaString> {};
+		template<> struct Staging<StringView> : StringStaging<StringView> {};
+
+		inline bool ConvertAllOrNothing(const StringView*, const TokenType*, const StringView*)
+		{
+			return true;
+		}
+
+		// Each value is staged, then the following ones are converted, and
+		// only when they all succeed are the values stored, last one first.
+		template<typename T, typename... Args>
+		bool ConvertAllOrNothing(const StringView* fields, const TokenType* types, const StringView* layouts, T& value, Args & ... args)
+		{
+			typename Staging<T>::type staged = typename Staging<T>::type();
+			if (Staging<T>::Stage(fields[0], types[0], layouts[0], staged) == false)
+				return false;
+			if (ConvertAllOrNothing(fields + 1, types + 1, layouts + 1, args...) == false)
+				return false;
+			Staging<T>::Commit(staged, fields[0], types[0], value);
+			return true;
+		}
+	}
+
+	// Matches and extracts in one pass over the input. Returns false at the
+	// first delimiter which is not found, or when a value cannot be
+	// converted, and then the parameters are left untouched.
+	template<typename... Args>
+	bool TryExtract(StringView input, const std::vector<Token>& tokens, Args & ... args)
+	{
+		if (detail::CountArgs(tokens) != sizeof...(Args))
+			return false;
+
+		detail::StatsScope stats(detail::TokensView(tokens), input);
+		StringView fields[sizeof...(Args) + 1];
+		TokenType types[sizeof...(Args) + 1] = {};
+		StringView layouts[sizeof...(Args) + 1];
+		size_t pos = 0;
+		size_t count = 0;
+		for (size_t i = 0; i < tokens.size(); ++i)
+		{
+			const Token& curr = tokens[i];
+			StringView field;
+			if (detail::FindField(input, curr, pos, field) != ExtractError::None)
+			{
+				stats.Miss(i);
+				return false;
+			}
+
+			if (curr.type != TokenType::None)
+			{
+				fields[count] = field;
+				types[count] = curr.type;
+				layouts[count] = curr.layout;
+				++count;
+			}
+		}
+
+		stats.Match();
+		if (detail::ConvertAllOrNothing(fields, types, layouts, args...) == false)
+		{
+			stats.ConversionError();
+			return false;
+		}
+		return true;
+	}
+
+	// A format ready to be matched many times. The literals between the
+	// fields are kept one after the other in a single buffer with the way
+	// each one is searched for, and the number and the types of the
+	// parameters are counted once. Every literal is searched for once: the
+	// postfix of a field is the prefix of the next one, and it is already
+	// known to be where the field ends.
+	class CompiledFormat
+	{
+	public:
+		CompiledFormat()
+			: m_args(0)
+			, m_anchoredStart(false)
+			, m_anchoredEnd(false)
+		{
+		}
+
+		explicit CompiledFormat(const char* fmt)
+			: CompiledFormat(TokenizeFmtString(fmt))
+		{
+		}
+
+		// The tokens are the ones of TokenizeFmtString, whose searchers
+		// are reused
+		CompiledFormat(const std::vector<Token>& tokens)
+			: m_args(0)
+			, m_anchoredStart(false)
+			, m_anchoredEnd(false)
+		{
+			if (tokens.empty())
+				return;
+
+			size_t size = tokens.back().postfix.size();
+			for (const auto& token : tokens)
+				size += token.prefix.size() + token.trimChars.size() + token.layout.size();
+			m_arena.reserve(size);
+			m_literals.reserve(tokens.size() + 1);
+			m_types.reserve(tokens.size());
+			m_widths.reserve(tokens.size());
+			m_fieldArgs.reserve(tokens.size());
+
+			for (const auto& token : tokens)
+			{
+				AddLiteral(token.prefix, token.prefixSearcher, token.prefixAnchor);
+				m_types.push_back(token.type);
+				m_widths.push_back(token.width);
+				const std::string& arg = (token.type == TokenType::Timestamp) ? token.layout : token.trimChars;
+				FieldArgEntry entry = { m_arena.size(), arg.size() };
+				m_fieldArgs.push_back(entry);
+				m_arena += arg;
+				if (token.type != TokenType::None)
+					m_argTypes.push_back(token.type);
+			}
+			AddLiteral(tokens.back().postfix, tokens.back().postfixSearcher, tokens.back().postfixAnchor);
+
+			m_args = m_argTypes.size();
+			const detail::Anchor& first = m_literals.front().anchor;
+			const detail::Anchor& last = m_literals.back().anchor;
+			m_anchoredStart = (first.kind == detail::AnchorKind::Offset && first.offset == 0) ||
+				(first.Anchored() == false && m_literals.front().size == 0);
+			m_anchoredEnd = last.kind == detail::AnchorKind::End ||
+				(last.Anchored() == false && m_literals.back().size == 0);
+		}
+
+		// True if the fmt is invalid
+		bool Empty() const { return m_types.empty(); }
+
+		// Number of parameters to extract into, the {x} fields aside
+		size_t Args() const { return m_args; }
+
+		TokenType ArgType(size_t arg) const { return m_argTypes[arg]; }
+
+		// Number of fields, the {x} ones included
+		size_t Fields() const { return m_types.size(); }
+
+		TokenType FieldType(size_t index) const { return m_types[index]; }
+
+		// 0 if the postfix ends the field
+		size_t FieldWidth(size_t index) const { return m_widths[index]; }
+
+		// The characters trimmed from a {t} field or the layout of a {ts}
+		// field, empty for the default ones
+		StringView FieldArg(size_t index) const
+		{
+			return StringView(m_arena.data() + m_fieldArgs[index].offset, m_fieldArgs[index].size);
+		}
+
+		// The literal before the field, or after the last field for
+		// Fields(); the first and the last literal can be empty
+		StringView Literal(size_t index) const
+		{
+			return StringView(m_arena.data() + m_literals[index].offset, m_literals[index].size);
+		}
+
+		// The input is matched from its start: the fmt starts with {^} or
+		// with a field
+		bool AnchoredStart() const { return m_anchoredStart; }
+
+		// The input is matched to its end: the fmt ends with {$} or with a
+		// field
+		bool AnchoredEnd() const { return m_anchoredEnd; }
+
+		// Same as FindField over the tokens. pos is where the previous
+		// field ended, and its postfix starts there.
+		ExtractError FindField(StringView input, size_t index, size_t& pos, StringView& field) const
+		{
+			const LiteralEntry& prefix = m_literals[index];
+			size_t start = pos;
+			if (index == 0 && (prefix.size != 0 || prefix.anchor.Anchored()))
+			{
+				start = detail::Locate(input, Literal(0), prefix.searcher, prefix.anchor, start);
+				if (start == StringView::npos)
+					return ExtractError::PrefixNotFound;
+			}
+			pos = start + prefix.size;
+
+			const LiteralEntry& postfix = m_literals[index + 1];
+			const detail::Delimiter after = { Literal(index + 1), postfix.searcher, postfix.anchor };
+			const StringView arg = FieldArg(index);
+			ExtractError error = detail::FindField(input, detail::Delimiter(), after, m_widths[index], m_types[index], arg, pos, field);
+			field = detail::TrimField(field, m_types[index], arg);
+			return error;
+		}
+
+		bool Match(StringView input) const
+		{
+			detail::StatsScope stats(*this, input);
+			size_t pos = 0;
+			for (size_t i = 0; i < m_types.size(); ++i)
+			{
+				StringView field;
+				if (FindField(input, i, pos, field) != ExtractError::None)
+				{
+					stats.Miss(i);
+					return false;
+				}
+			}
+			stats.Match();
+			return true;
+		}
+
+		// Same as ValuesExtractChecked
+		template<typename... Args>
+		ExtractResult Extract(StringView input, Args & ... args) const
+		{
+			if (m_args != sizeof...(Args))
+				return detail::ArgCountMismatch();
+
+			detail::StatsScope stats(*this, input);
+			Scanner scanner(input, *this);
+
+			ExtractResult result = detail::ExtractArgs<true>(scanner, args...);
+			stats.Done(result);
+			return result;
+		}
+
+		// Same as TryExtract
+		template<typename... Args>
+		bool TryExtract(StringView input, Args & ... args) const
+		{
+			if (m_args != sizeof...(Args))
+				return false;
+
+			detail::StatsScope stats(*this, input);
+			StringView fields[sizeof...(Args) + 1];
+			TokenType types[sizeof...(Args) + 1] = {};
+			StringView layouts[sizeof...(Args) + 1];
+			size_t pos = 0;
+			size_t count = 0;
+			for (size_t i = 0; i < m_types.size(); ++i)
+			{
+				StringView field;
+				if (FindField(input, i, pos, field) != ExtractError::None)
+				{
+					stats.Miss(i);
+					return false;
+				}
+
+				if (m_types[i] != TokenType::None)
+				{
+					fields[count] = field;
+					types[count] = m_types[i];
+					layouts[count] = FieldArg(i);
+					++count;
+				}
+			}
+
+			stats.Match();
+			if (detail::ConvertAllOrNothing(fields, types, layouts, args...) == false)
+			{
+				stats.ConversionError();
+				return false;
+			}
+			return true;
+		}
+
+		// Same as detail::FieldScanner
+		class Scanner
+		{
+		public:
+			Scanner(StringView input, const CompiledFormat& format)
+				: m_input(input)
+				, m_format(format)
+				, m_index(0)
+				, m_pos(0)
+			{
+			}
+
+			ExtractError Next(StringView& field, TokenType& type, StringView& layout)
+			{
+				while (m_index < m_format.m_types.size())
+				{
+					const size_t index = m_index++;
+
+					ExtractError error = m_format.FindField(m_input, index, m_pos, field);
+					if (error != ExtractError::None)
+						return error;
+
+					if (m_format.m_types[index] != TokenType::None)
+					{
+						type = m_format.m_types[index];
+						layout = m_format.FieldArg(index);
+						return ExtractError::None;
+					}
+				}
+				return ExtractError::None;
+			}
+
+			ExtractError Finish()
+			{
+				StringView field;
+				TokenType type;
+				StringView layout;
+				return Next(field, type, layout);
+			}
+
+			ExtractResult Fail(ExtractError error, size_t offset) const
+			{
+				ExtractResult result = { error, static_cast<int32_t>(m_index) - 1, offset };
+				return result;
+			}
+
+			ExtractResult Fail(ExtractError error) const
+			{
+				return Fail(error, m_pos);
+			}
+
+			size_t Offset(StringView field) const
+			{
+				return static_cast<size_t>(field.data - m_input.data);
+			}
+
+		private:
+			StringView m_input;
+			const CompiledFormat& m_format;
+			size_t m_index;
+			size_t m_pos;
+		};
+
+	private:
+		struct LiteralEntry
+		{
+			size_t offset;
+			size_t size;
+			detail::Searcher searcher;
+			detail::Anchor anchor;
+		};
+
+		// The argument of a field, kept with the literals
+		struct FieldArgEntry
+		{
+			size_t offset;
+			size_t size;
+		};
+
+		void AddLiteral(const std::string& literal, const detail::Searcher& searcher, const detail::Anchor& anchor)
+		{
+			LiteralEntry entry;
+			entry.offset = m_arena.size();
+			entry.size = literal.size();
+			entry.searcher = (searcher.size == literal.size()) ? searcher : detail::MakeSearcher(literal);
+			entry.anchor = anchor;
+			m_literals.push_back(entry);
+			m_arena += literal;
+		}
+
+		std::string m_arena;
+		std::vector<LiteralEntry> m_literals;
+		std::vector<TokenType> m_types;
+		std::vector<size_t> m_widths;
+		std::vector<FieldArgEntry> m_fieldArgs;
+		std::vector<TokenType> m_argTypes;
+		size_t m_args;
+		bool m_anchoredStart;
+		bool m_anchoredEnd;
+	};
+
+	// Same as ValuesExtract over the tokens
+	template<typename... Args>
+	void ValuesExtract(StringView input, const CompiledFormat& format, Args & ... args)
+	{
+		if (format.Args() != sizeof...(Args))
+		{
+			std::cerr << "Number of parameters and fmt token mismatched\n";
+			return;
+		}
+
+		detail::StatsScope stats(format, input);
+		CompiledFormat::Scanner scanner(input, format);
+
+		ExtractResult result = detail::ExtractArgs<false>(scanner, args...);
+		stats.Done(result);
+		detail::PrintScanError(result.error);
+	}
+
+	struct FormatCacheStats
+	{
+		uint64_t hits;
+		uint64_t misses;
+		size_t size;
+		size_t capacity;
+	};
+
+	namespace detail
+	{
+		inline uint64_t HashFmt(const char* fmt, size_t size)
+		{
+			// FNV-1a
+			uint64_t hash = 14695981039346656037ULL;
+			for (size_t i = 0; i < size; ++i)
+			{
+				hash ^= static_cast<unsigned char>(fmt[i]);
+				hash *= 1099511628211ULL;
+			}
+			return hash;
+		}
+
+		// Each thread counts in its own stripe of the counters
+		inline size_t ThreadStripe()
+		{
+			static std::atomic<size_t> next(0);
+			static thread_local size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+			return stripe;
+		}
+	}
+
+	// Compiled formats looked up by the content of the fmt. A lookup reads
+	// the table without a lock: a slot is written once, under the lock, and
+	// an entry is not modified nor freed until the cache is destroyed, so
+	// the pointer returned stays valid as long as the cache. When the slots
+	// around the hash of a fmt are all taken, Get returns nullptr and the
+	// caller tokenizes the fmt as it would without a cache.
+	class FormatCache
+	{
+	public:
+		static const size_t DefaultCapacity = 1024;
+		static const size_t MaxProbes = 16;
+
+		// The capacity is rounded up to a power of 2
+		explicit FormatCache(size_t capacity = DefaultCapacity)
+			: m_mask(0)
+			, m_size(0)
+		{
+			size_t slots = 1;
+			while (slots < capacity)
+				slots *= 2;
+			m_mask = slots - 1;
+			m_slots.reset(new std::atomic<Entry*>[slots]);
+			for (size_t i = 0; i < slots; ++i)
+				m_slots[i].store(nullptr, std::memory_order_relaxed);
+			for (auto& counter : m_counters)
+			{
+				counter.hits.store(0, std::memory_order_relaxed);
+				counter.misses.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		~FormatCache()
+		{
+			for (size_t i = 0; i <= m_mask; ++i)
+				delete m_slots[i].load(std::memory_order_relaxed);
+		}
+
+		FormatCache(const FormatCache&) = delete;
+		FormatCache& operator=(const FormatCache&) = delete;
+
+		const CompiledFormat* Get(const char* fmt)
+		{
+			const size_t size = strlen(fmt);
+			const uint64_t hash = detail::HashFmt(fmt, size);
+			Counter& counter = m_counters[detail::ThreadStripe() % Stripes];
+
+			bool full = false;
+			const CompiledFormat* format = Find(fmt, size, hash, full);
+			if (format)
+			{
+				counter.hits.fetch_add(1, std::memory_order_relaxed);
+				return format;
+			}
+			counter.misses.fetch_add(1, std::memory_order_relaxed);
+			if (full)
+				return nullptr;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			for (size_t probe = 0; probe < MaxProbes; ++probe)
+			{
+				std::atomic<Entry*>& slot = m_slots[(hash + probe) & m_mask];
+				Entry* curr = slot.load(std::memory_order_relaxed);
+				if (curr == nullptr)
+				{
+					Entry* entry = new Entry(fmt, size, hash);
+					// released to the readers, who acquire it
+					slot.store(entry, std::memory_order_release);
+					++m_size;
+					return &entry->format;
+				}
+				// added by another thread since Find
+				if (curr->Is(fmt, size, hash))
+					return &curr->format;
+			}
+			return nullptr;
+		}
+
+		FormatCacheStats Stats() const
+		{
+			FormatCacheStats stats = { 0, 0, 0, m_mask + 1 };
+			for (const auto& counter : m_counters)
+			{
+				stats.hits += counter.hits.load(std::memory_order_relaxed);
+				stats.misses += counter.misses.load(std::memory_order_relaxed);
+			}
+			std::lock_guard<std::mutex> lock(m_mutex);
+			stats.size = m_size;
+			return stats;
+		}
+
+	private:
+		struct Entry
+		{
+			Entry(const char* fmt_, size_t size, uint64_t hash_)
+				: hash(hash_)
+				, fmt(fmt_, size)
+				, format(fmt_)
+			{
+			}
+
+			bool Is(const char* other, size_t size, uint64_t otherHash) const
+			{
+				return hash == otherHash && fmt.size() == size && memcmp(fmt.data(), other, size) == 0;
+			}
+
+			uint64_t hash;
+			std::string fmt;
+			CompiledFormat format;
+		};
+
+		// Padded so that the threads do not share a cache line
+		struct Counter
+		{
+			std::atomic<uint64_t> hits;
+			std::atomic<uint64_t> misses;
+			char padding[64 - 2 * sizeof(std::atomic<uint64_t>)];
+		};
+
+		static const size_t Stripes = 16;
+
+		// full is set when there is no room left for the fmt
+		const CompiledFormat* Find(const char* fmt, size_t size, uint64_t hash, bool& full) const
+		{
+			for (size_t probe = 0; probe < MaxProbes; ++probe)
+			{
+				const Entry* curr = m_slots[(hash + probe) & m_mask].load(std::memory_order_acquire);
+				if (curr == nullptr)
+					return nullptr;
+				if (curr->Is(fmt, size, hash))
+					return &curr->format;
+			}
+			full = true;
+			return nullptr;
+		}
+
+		std::unique_ptr<std::atomic<Entry*>[]> m_slots;
+		size_t m_mask;
+		size_t m_size;
+		mutable std::mutex m_mutex;
+		Counter m_counters[Stripes];
+	};
+
+	// The cache used by the overloads taking a fmt string once it is enabled
+	inline FormatCache& GlobalFormatCache()
+	{
+		static FormatCache cache;
+		return cache;
+	}
+
+	namespace detail
+	{
+		inline std::atomic<bool>& FormatCacheEnabled()
+		{
+			static std::atomic<bool> enabled(false);
+			return enabled;
+		}
+
+		// nullptr when the cache is disabled or full
+		inline const CompiledFormat* CachedFormat(const char* fmt)
+		{
+			if (FormatCacheEnabled().load(std::memory_order_relaxed) == false)
+				return nullptr;
+			return GlobalFormatCache().Get(fmt);
+		}
+	}
+
+	// The overloads taking a fmt string look it up in GlobalFormatCache
+	// instead of tokenizing it on every call. Disabling it does not clear it.
+	inline void EnableFormatCache(bool enable = true)
+	{
+		detail::FormatCacheEnabled().store(enable, std::memory_order_relaxed);
+	}
+
+	template<typename... Args>
+	void ValuesExtract(StringView input, const char* fmt, Args & ... args)
+	{
+		const CompiledFormat* format = detail::CachedFormat(fmt);
+		if (format)
+		{
+			ValuesExtract(input, *format, args...);
+			return;
+		}
+
+		std::vector<Token> tokens = TokenizeFmtString(fmt);
+
+		ValuesExtract(input, tokens, args...);
+	}
+
+	template<typename... Args>
+	ExtractResult ValuesExtractChecked(StringView input, const char* fmt, Args & ... args)
+	{
+		const CompiledFormat* format = detail::CachedFormat(fmt);
+		if (format)
+			return format->Extract(input, args...);
+
+		std::vector<Token> tokens = TokenizeFmtString(fmt);
+
+		return ValuesExtractChecked(input, tokens, args...);
+	}
+
+	template<typename... Args>
+	bool TryExtract(StringView input, const char* fmt, Args & ... args)
+	{
+		const CompiledFormat* format = detail::CachedFormat(fmt);
+		if (format)
+			return format->TryExtract(input, args...);
+
+		std::vector<Token> tokens = TokenizeFmtString(fmt);
+
+		return TryExtract(input, tokens, args...);
+	}
+
+	namespace detail
+	{
+		// Matches the tokens over the input the same way ValuesExtract does
+		// and collects the fields which are extracted into a parameter.
+		inline bool MatchFields(StringView input, const std::vector<Token>& tokens, std::vector<StringView>* fields, size_t* failed = nullptr)
+		{
+			size_t pos = 0;
+			for (const auto& curr : tokens)
+			{
+				StringView field;
+				if (FindField(input, curr, pos, field) != ExtractError::None)
+				{
+					if (failed)
+						*failed = static_cast<size_t>(&curr - tokens.data());
+					return false;
+				}
+
+				if (fields && curr.type != TokenType::None)
+					fields->push_back(field);
+			}
+			return true;
+		}
+	}
+
+	// Same as matching the tokens with ValuesExtract, without converting
+	// the fields
+	inline bool IsInputMatchedTokens(StringView input, const std::vector<Token>& tokens)
+	{
+		detail::StatsScope stats(detail::TokensView(tokens), input);
+		size_t failed = 0;
+		if (detail::MatchFields(input, tokens, nullptr, &failed) == false)
+		{
+			stats.Miss(failed);
+			return false;
+		}
+		stats.Match();
+		return true;
+	}
+
+	inline bool IsInputMatchedFmt(StringView input, const char* fmt)
+	{
+		std::vector<Token> tokens = TokenizeFmtString(fmt);
+
+		return IsInputMatchedTokens(input, tokens);
+	}
+	namespace detail
+	{
+		// Aho-Corasick automaton: finds the occurrences of many literals in
+		// one pass over the input. The states nearest to the root, where the
+		// scan spends most of its time, get a dense transition table over the
+		// byte classes; the deeper ones keep sorted edges and failure links.
+		class LiteralMatcher
+		{
+		public:
+			LiteralMatcher()
+				: m_trie(1)
+				, m_denseStates(0)
+				, m_classCount(1)
+				, m_patterns(0)
+			{
+				std::fill(m_class, m_class + 256, static_cast<uint16_t>(0));
+			}
+
+			// Returns the id of the literal, the same id for the same literal.
+			// Build has to be called again before Scan sees it.
+			size_t Add(StringView literal)
+			{
+				int32_t state = 0;
+				for (char ch : literal)
+				{
+					unsigned char c = static_cast<unsigned char>(ch);
+					std::vector<Edge>& edges = m_trie[state].edges;
+					auto it = std::lower_bound(edges.begin(), edges.end(), c, EdgeLess());
+					if (it != edges.end() && it->ch == c)
+					{
+						state = it->next;
+						continue;
+					}
+					int32_t next = static_cast<int32_t>(m_trie.size());
+					edges.insert(it, Edge{ c, next });
+					m_trie.push_back(TrieNode());
+					state = next;
+				}
+				if (m_trie[state].pattern < 0)
+					m_trie[state].pattern = static_cast<int32_t>(m_patterns++);
+				return static_cast<size_t>(m_trie[state].pattern);
+			}
+
+			size_t PatternCount() const
+			{
+				return m_patterns;
+			}
+
+			void Build()
+			{
+				// the bytes which are in no literal share class 0
+				bool used[256] = {};
+				for (const TrieNode& node : m_trie)
+				{
+					for (const Edge& edge : node.edges)
+						used[edge.ch] = true;
+				}
+				m_classCount = 1;
+				for (int c = 0; c < 256; ++c)
+					m_class[c] = used[c] ? static_cast<uint16_t>(m_classCount++) : 0;
+
+				// States are numbered in breadth first order, so that a
+				// failure link goes to a lower number and the dense states
+				// come first.
+				std::vector<int32_t> queue(1, 0);
+				for (size_t head = 0; head < queue.size(); ++head)
+				{
+					for (const Edge& edge : m_trie[queue[head]].edges)
+						queue.push_back(edge.next);
+				}
+				std::vector<int32_t> order(m_trie.size());
+				for (size_t i = 0; i < queue.size(); ++i)
+					order[queue[i]] = static_cast<int32_t>(i);
+
+				m_nodes.assign(m_trie.size(), Node());
+				m_edges.clear();
+				m_denseStates = 0;
+				for (size_t state = 0; state < queue.size(); ++state)
+				{
+					const TrieNode& trie = m_trie[queue[state]];
+					Node& node = m_nodes[state];
+					node.pattern = trie.pattern;
+					node.firstEdge = static_cast<uint32_t>(m_edges.size());
+					node.edgeCount = static_cast<uint32_t>(trie.edges.size());
+					for (Edge edge : trie.edges)
+					{
+						edge.next = order[edge.next];
+						m_edges.push_back(edge);
+					}
+				}
+
+				m_hasOutput.assign(m_nodes.size(), 0);
+				for (size_t state = 0; state < m_nodes.size(); ++state)
+				{
+					Node& node = m_nodes[state];
+					if (state != 0)
+					{
+						const Node& fail = m_nodes[node.fail];
+						node.output = (fail.pattern >= 0) ? node.fail : fail.output;
+					}
+					m_hasOutput[state] = (node.pattern >= 0 || node.output > 0) ? 1 : 0;
+
+					const Edge* edge = m_edges.data() + node.firstEdge;
+					for (uint32_t i = 0; i < node.edgeCount; ++i, ++edge)
+						m_nodes[edge->next].fail = (state == 0) ? 0 : Next(node.fail, edge->ch);
+				}
+
+				// The row of a failure link is filled in before it is copied
+				m_denseStates = std::min(m_nodes.size(), MaxDenseCells / m_classCount);
+				m_dense.assign(m_denseStates * m_classCount, 0);
+				for (size_t state = 0; state < m_denseStates; ++state)
+				{
+					int32_t* cells = &m_dense[state * m_classCount];
+					const Node& node = m_nodes[state];
+					if (state != 0)
+					{
+						const int32_t* failCells = &m_dense[node.fail * m_classCount];
+						std::copy(failCells, failCells + m_classCount, cells);
+					}
+					const Edge* edge = m_edges.data() + node.firstEdge;
+					for (uint32_t i = 0; i < node.edgeCount; ++i, ++edge)
+						cells[m_class[edge->ch]] = edge->next;
+				}
+			}
+
+			// Calls onMatch(literal id) for each occurrence in the input
+			template<typename F>
+			void Scan(StringView input, F onMatch) const
+			{
+				if (m_nodes.empty())
+					return;
+
+				const int32_t* dense = m_dense.data();
+				const uint8_t* hasOutput = m_hasOutput.data();
+				int32_t state = 0;
+				for (char ch : input)
+				{
+					unsigned char c = static_cast<unsigned char>(ch);
+					if (static_cast<size_t>(state) < m_denseStates)
+						state = dense[state * m_classCount + m_class[c]];
+					else
+						state = Next(state, c);
+					if (hasOutput[state] == 0)
+						continue;
+
+					const Node& node = m_nodes[state];
+					int32_t out = (node.pattern >= 0) ? state : node.output;
+					while (out > 0)
+					{
+						onMatch(static_cast<size_t>(m_nodes[out].pattern));
+						out = m_nodes[out].output;
+					}
+				}
+			}
+
+		private:
+			// cells of the dense rows, 4 MB at most
+			static const size_t MaxDenseCells = 1 << 20;
+
+			struct Edge
+			{
+				unsigned char ch;
+				int32_t next;
+			};
+			struct EdgeLess
+			{
+				bool operator()(const Edge& edge, unsigned char c) const { return edge.ch < c; }
+			};
+			struct TrieNode
+			{
+				TrieNode() : pattern(-1) {}
+
+				std::vector<Edge> edges;
+				int32_t pattern;
+			};
+			struct Node
+			{
+				Node() : fail(0), output(0), pattern(-1), firstEdge(0), edgeCount(0) {}
+
+				int32_t fail;
+				// next state on the failure chain which ends a literal, 0 if none
+				int32_t output;
+				int32_t pattern;
+				uint32_t firstEdge;
+				uint32_t edgeCount;
+			};
+
+			int32_t Next(int32_t state, unsigned char c) const
+			{
+				while (true)
+				{
+					if (static_cast<size_t>(state) < m_denseStates)
+						return m_dense[state * m_classCount + m_class[c]];
+
+					const Node& node = m_nodes[state];
+					const Edge* first = m_edges.data() + node.firstEdge;
+					const Edge* last = first + node.edgeCount;
+					const Edge* it = std::lower_bound(first, last, c, EdgeLess());
+					if (it != last && it->ch == c)
+						return it->next;
+					if (state == 0)
+						return 0;
+					state = node.fail;
+				}
+			}
+
+			std::vector<TrieNode> m_trie;
+			std::vector<Node> m_nodes;
+			std::vector<Edge> m_edges;
+			std::vector<uint8_t> m_hasOutput;
+			// rows of the states below m_denseStates
+			std::vector<int32_t> m_dense;
+			size_t m_denseStates;
+			uint16_t m_class[256];
+			size_t m_classCount;
+			size_t m_patterns;
+		};
+	}
+
+	// Format matched by FormatSet::Match with its fields
+	struct FormatMatch
+	{
+		size_t id;
+		StringView input;
+		std::vector<StringView> fields;
+	};
+
+	// A catalog of formats matched against an input at once. Every literal
+	// of a format has to be found in the input for the format to match, so
+	// the longest literal of each format is put in an Aho-Corasick automaton:
+	// one pass over the input gives the candidate formats, which are then
+	// matched in the order they were added. The first format which matches
+	// wins, as if the formats were tried one after the other.
+	class FormatSet
+	{
+	public:
+		static const size_t npos = static_cast<size_t>(-1);
+
+		FormatSet()
+			: m_built(false)
+		{
+		}
+
+		// Returns the id of the format, npos if it is invalid
+		size_t Add(const char* fmt)
+		{
+			return Add(TokenizeFmtString(fmt));
+		}
+
+		size_t Add(const std::vector<Token>& tokens)
+		{
+			if (tokens.empty())
+				return npos;
+
+			size_t id = m_formats.size();
+			m_formats.push_back(tokens);
+
+			StringView longest;
+			for (const auto& token : tokens)
+			{
+				if (token.prefix.size() > longest.size)
+					longest = token.prefix;
+				if (token.postfix.size() > longest.size)
+					longest = token.postfix;
+			}
+			if (longest.empty())
+			{
+				m_anyInput.push_back(static_cast<uint32_t>(id));
+			}
+			else
+			{
+				size_t literal = m_literals.Add(longest);
+				if (literal == m_literalFormats.size())
+					m_literalFormats.push_back(std::vector<uint32_t>());
+				m_literalFormats[literal].push_back(static_cast<uint32_t>(id));
+			}
+			m_built = false;
+			return id;
+		}
+
+		// To be called after the last Add and before Match. Until then,
+		// Match tries all the formats one after the other.
+		void Build()
+		{
+			m_literals.Build();
+			m_built = true;
+		}
+
+		size_t Size() const
+		{
+			return m_formats.size();
+		}
+
+		const std::vector<Token>& Tokens(size_t id) const
+		{
+			return m_formats.at(id);
+		}
+
+		// Returns the id of the first format which matches, npos if none
+		size_t Match(StringView input) const
+		{
+			return MatchImpl(input, nullptr);
+		}
+
+		bool Match(StringView input, FormatMatch& match) const
+		{
+			match.input = input;
+			match.fields.clear();
+			match.id = MatchImpl(input, &match.fields);
+			return match.id != npos;
+		}
+
+		// Converts the fields of a match into the parameters
+		template<typename... Args>
+		ExtractResult Convert(const FormatMatch& match, Args & ... args) const
+		{
+			if (match.id >= m_formats.size() || match.fields.size() != sizeof...(Args))
+				return detail::ArgCountMismatch();
+
+			return ConvertFields(match, 0, 0, args...);
+		}
+
+	private:
+		// Up to this many formats, trying them one after the other is faster
+		// than a pass of the automaton, whose cost is per input byte.
+		static const size_t LinearFormats = 16;
+
+		size_t MatchImpl(StringView input, std::vector<StringView>* fields) const
+		{
+			if (m_built == false || m_formats.size() <= LinearFormats)
 			{
-				std::string str2;
-				if (tokenType == TokenType::Trim)
-				{
-					str2 = Trim(str, " \r\n\t\v");
-				}
-				else
+				for (size_t id = 0; id < m_formats.size(); ++id)
 				{
-					str2 = str;
+					if (TryFormat(input, id, fields))
+						return id;
 				}
-				*(m_ptr.pws) = L"";
-				for (char ch : str2)
-					*(m_ptr.pws) += (wchar_t)ch;
+				return npos;
 			}
-				return true;
-			case DTR_INT64:
+
+			// The candidates are the bits of a bitmap of the formats, so they
+			// come out in id order without a sort. A literal found several
+			// times in the input sets the bits of its formats once: its
+			// stamp is the epoch of the last Match which found it. The
+			// scratch is kept by the thread and only allocates until it has
+			// grown to the largest set.
+			static thread_local MatchScratch scratch;
+			if (++scratch.epoch == 0)
 			{
-				*(m_ptr.pi64) = strtoll(str.c_str() + offset, nullptr, base);
-				return true;
+				std::fill(scratch.stamps.begin(), scratch.stamps.end(), 0);
+				scratch.epoch = 1;
 			}
-			case DTR_UINT64:
+			if (scratch.stamps.size() < m_literalFormats.size())
+				scratch.stamps.resize(m_literalFormats.size(), 0);
+			const size_t words = (m_formats.size() + 31) / 32;
+			if (scratch.bits.size() < words)
+				scratch.bits.resize(words, 0);
+
+			size_t first = words;
+			size_t last = 0;
+			auto mark = [&](const std::vector<uint32_t>& ids)
 			{
-				*(m_ptr.pui64) = strtoull(str.c_str() + offset, nullptr, base);
-				return true;
-			}
-			case DTR_CHAR:
-				if (str.size() > 0)
-				{
-					*(m_ptr.pc) = (char)str[0];
-					return true;
-				}
-				else
-					return false;
-			case DTR_UCHAR:
-				if (str.size() > 0)
+				for (uint32_t id : ids)
 				{
-					*(m_ptr.puc) = (unsigned char)str[0];
-					return true;
+					const size_t word = id >> 5;
+					scratch.bits[word] |= 1u << (id & 31);
+					first = std::min(first, word);
+					last = std::max(last, word + 1);
 				}
-				else
-					return false;
-			case DTR_WCHAR:
-				if (str.size() > 0)
+			};
+			mark(m_anyInput);
+			m_literals.Scan(input, [&](size_t literal)
+			{
+				if (scratch.stamps[literal] == scratch.epoch)
+					return;
+				scratch.stamps[literal] = scratch.epoch;
+				mark(m_literalFormats[literal]);
+			});
+
+			size_t found = npos;
+			for (size_t word = first; word < last; ++word)
+			{
+				uint32_t mask = scratch.bits[word];
+				scratch.bits[word] = 0;
+				while (mask != 0 && found == npos)
 				{
-					*(m_ptr.pwc) = str.at(0);
-					return true;
+					const size_t id = word * 32 + detail::CountTrailingZeros(mask);
+					mask &= mask - 1;
+					if (TryFormat(input, id, fields))
+						found = id;
 				}
-				else
-					return false;
-			default:
-				return false;
+			}
+			return found;
+		}
+
+		struct MatchScratch
+		{
+			MatchScratch()
+				: epoch(0)
+			{
 			}
 
+			// epoch of the last Match which found the literal
+			std::vector<uint32_t> stamps;
+			uint32_t epoch;
+			// bit (id & 31) of word (id >> 5) is set when format id is a candidate
+			std::vector<uint32_t> bits;
+		};
+
+		bool TryFormat(StringView input, size_t id, std::vector<StringView>* fields) const
+		{
+			if (detail::MatchFields(input, m_formats[id], fields))
+				return true;
+			if (fields)
+				fields->clear();
 			return false;
 		}
 
-		DTR_TYPE m_type;
-
-		UNIONPTR m_ptr;
-	};
+		ExtractResult ConvertFields(const FormatMatch&, size_t, size_t) const
+		{
+			return detail::Success();
+		}
 
-	namespace detail
-	{
-		inline std::vector<Token> Find(const std::string& input, const char* find, TokenType type)
+		template<typename T, typename... Args>
+		ExtractResult ConvertFields(const FormatMatch& match, size_t token, size_t field, T& value, Args & ... args) const
 		{
-			std::vector<Token> vec;
-			size_t find_size = strlen(find);
-			if (find_size == 0)
-				return {};
+			const std::vector<Token>& tokens = m_formats[match.id];
+			while (tokens[token].type == TokenType::None)
+				++token;
 
-			size_t pos = 0;
-			pos = input.find(find);
-			while (pos != std::string::npos)
+			StringView str = match.fields[field];
+			ExtractError error = detail::ConvertField(str, tokens[token].type, tokens[token].layout, value);
+			if (error != ExtractError::None)
 			{
-				vec.push_back({ -1, pos, find_size, type });
-				pos += find_size;
-				pos = input.find(find, pos);
+				ExtractResult result = { error, static_cast<int32_t>(token), static_cast<size_t>(str.data - match.input.data) };
+				return result;
 			}
-			return vec;
+			return ConvertFields(match, token + 1, field + 1, args...);
 		}
-	}
 
-	inline std::vector<Token> TokenizeFmtString(const std::string& fmt)
+		std::vector<std::vector<Token> > m_formats;
+		detail::LiteralMatcher m_literals;
+		// formats by literal id
+		std::vector<std::vector<uint32_t> > m_literalFormats;
+		// formats without a literal, which may match any input
+		std::vector<uint32_t> m_anyInput;
+		bool m_built;
+	};
+	enum class ColumnType : uint8_t
 	{
-		std::vector<Token> vecMatter = detail::Find(fmt, "{}", TokenType::Matter);
-		std::vector<Token> vecHex = detail::Find(fmt, "{h}", TokenType::Hex);
-		std::vector<Token> vecX = detail::Find(fmt, "{x}", TokenType::None);
-		std::vector<Token> vecTrim = detail::Find(fmt, "{t}", TokenType::Trim);
+		Int64,
+		Double,
+		String
+	};
 
-		std::vector<Token> vec;
-		for (auto& a : vecMatter)
+	// One field of a batch of rows, laid out like an Arrow array: the values
+	// of a row without a value (no match, or a conversion error) are 0 or
+	// the empty string and its validity bit is cleared.
+	struct Column
+	{
+		explicit Column(ColumnType columnType = ColumnType::String)
+			: type(columnType)
+			, rows(0)
 		{
-			vec.push_back(a);
+			offsets.push_back(0);
 		}
-		for (auto& a : vecHex)
+
+		void Clear()
 		{
-			vec.push_back(a);
+			int64s.clear();
+			doubles.clear();
+			offsets.assign(1, 0);
+			bytes.clear();
+			validity.clear();
+			rows = 0;
 		}
-		for (auto& a : vecX)
+
+		bool IsValid(size_t row) const
 		{
-			vec.push_back(a);
+			return (validity[row >> 3] >> (row & 7)) & 1;
 		}
-		for (auto& a : vecTrim)
+
+		StringView String(size_t row) const
 		{
-			vec.push_back(a);
+			return StringView(bytes.data() + offsets[row], static_cast<size_t>(offsets[row + 1] - offsets[row]));
 		}
 
-		int countDiffTokenType = 0;
-		if (vecMatter.size() > 0)
-			countDiffTokenType++;
-		if (vecHex.size() > 0)
-			countDiffTokenType++;
-		if (vecX.size() > 0)
-			countDiffTokenType++;
-		if (vecTrim.size() > 0)
-			countDiffTokenType++;
+		ColumnType type;
+		// values of an Int64 column
+		std::vector<int64_t> int64s;
+		// values of a Double column
+		std::vector<double> doubles;
+		// string of row i of a String column is bytes[offsets[i], offsets[i + 1]);
+		// 64-bit like an Arrow LargeString, so bytes may outgrow 4 GiB
+		std::vector<uint64_t> offsets;
+		std::string bytes;
+		// bit (i & 7) of byte (i >> 3) is set when row i has a value
+		std::vector<uint8_t> validity;
+		size_t rows;
+	};
 
-		if (countDiffTokenType > 1)
+	// Extracts many lines with one format into a column per parameter. The
+	// lines of a batch are scanned first, then each column is converted in
+	// one go, so the column type is dispatched once per batch and the
+	// writes to a column are contiguous.
+	class BatchExtractor
+	{
+	public:
+		BatchExtractor(const std::vector<Token>& tokens, const std::vector<ColumnType>& types)
+			: m_tokens(tokens)
 		{
-			if (std::is_sorted(vec.begin(), vec.end(), [](const Token& a, const Token& b)
-				{ return a.start < b.start; }) == false)
+			if (detail::CountArgs(tokens) != types.size())
+				throw std::runtime_error("Number of column types and fmt token mismatched");
+
+			for (size_t i = 0; i < tokens.size(); ++i)
 			{
-				std::sort(vec.begin(), vec.end(), [](const Token& a, const Token& b)
-					{ return a.start < b.start; });
+				if (tokens[i].type != TokenType::None)
+					m_fieldTokens.push_back(i);
 			}
+			for (ColumnType type : types)
+				m_columns.push_back(Column(type));
 		}
 
-		for (size_t i = 0; i < vec.size(); ++i)
+		BatchExtractor(const char* fmt, const std::vector<ColumnType>& types)
+			: BatchExtractor(TokenizeFmtString(fmt), types)
 		{
-			auto& curr = vec[i];
+		}
 
-			if (i == 0)
-			{
-				if (curr.start == 0)
-				{
-					curr.prefix = "";
-				}
-				else
-				{
-					curr.prefix = fmt.substr(0, curr.start);
-				}
+		// Appends a row per line and returns the number of lines matched
+		size_t Extract(const StringView* lines, size_t count)
+		{
+			const size_t fieldCount = m_columns.size();
+			m_fields.resize(count * fieldCount);
+			m_matched.resize(count);
 
-				if (i + 1 < vec.size())
-				{
-					auto& next = vec[i + 1];
-					if (curr.start + curr.size == next.start)
-					{
-						std::cerr << "Error: Format specifier {} cannot be side by side! For example: {}{}\n";
-						return {};
-					}
-					else if (curr.start + curr.size < next.start)
-					{
-						curr.postfix = fmt.substr(curr.start + curr.size, next.start - (curr.start + curr.size));
-					}
-				}
-				else
-				{
-					curr.postfix = fmt.substr(curr.start + curr.size);
-				}
-				continue;
+			size_t matched = 0;
+			for (size_t row = 0; row < count; ++row)
+			{
+				m_matched[row] = ScanLine(lines[row], &m_fields[row * fieldCount]) ? 1 : 0;
+				matched += m_matched[row];
 			}
 
-			if (i + 1 < vec.size() && i > 0)
+			for (size_t field = 0; field < fieldCount; ++field)
 			{
-				auto& prev = vec[i - 1];
-
-				curr.prefix = fmt.substr(prev.start + prev.size, curr.start - (prev.start + prev.size));
-
-				auto& next = vec[i + 1];
-				if (curr.start + curr.size == next.start)
-				{
-					std::cerr << "Error: Format specifier {} cannot be side by side! For example: {}{}\n";
-					return {};
-				}
-				else if (curr.start + curr.size < next.start)
+				Column& column = m_columns[field];
+				Reserve(column, column.rows + count);
+				switch (column.type)
 				{
-					curr.postfix = fmt.substr(curr.start + curr.size, next.start - (curr.start + curr.size));
+				case ColumnType::Int64:
+					ConvertColumn(column, field, count, column.int64s);
+					break;
+				case ColumnType::Double:
+					ConvertColumn(column, field, count, column.doubles);
+					break;
+				case ColumnType::String:
+					ConvertStrings(column, field, count);
+					break;
 				}
-				continue;
 			}
+			return matched;
+		}
 
-			if (i == (vec.size() - 1) && i > 0)
-			{
-				auto& prev = vec[i - 1];
+		size_t Extract(const std::vector<StringView>& lines)
+		{
+			return Extract(lines.data(), lines.size());
+		}
 
-				curr.prefix = fmt.substr(prev.start + prev.size, curr.start - (prev.start + prev.size));
-				curr.postfix = fmt.substr(curr.start + curr.size);
+		// Lines of a buffer: line i is buffer[offsets[i], offsets[i + 1]),
+		// without its "\n" or "\r\n" if any, like ForEachLine gives them
+		size_t Extract(StringView buffer, const std::vector<size_t>& offsets)
+		{
+			m_lines.clear();
+			for (size_t i = 0; i + 1 < offsets.size(); ++i)
+			{
+				StringView line = buffer.substr(offsets[i], offsets[i + 1] - offsets[i]);
+				if (line.empty() == false && line[line.size - 1] == '\n')
+					--line.size;
+				m_lines.push_back(detail::MakeLine(line.data, line.data + line.size));
 			}
+			return Extract(m_lines.data(), m_lines.size());
 		}
 
-		int index = 0;
-		for (auto& a : vec)
+		// Removes the rows, keeping the memory of the columns
+		void Clear()
 		{
-			if (a.type != TokenType::None)
-			{
-				a.index = index;
+			for (auto& column : m_columns)
+				column.Clear();
+		}
 
-				++index;
-			}
+		size_t Rows() const
+		{
+			return m_columns.empty() ? 0 : m_columns[0].rows;
 		}
 
-		return vec;
-	}
-	namespace detail
-	{
+		const std::vector<Column>& Columns() const
+		{
+			return m_columns;
+		}
 
-		inline void AddData(std::vector<DataTypeRef>& results)
+		const Column& GetColumn(size_t field) const
 		{
+			return m_columns.at(field);
 		}
 
+	private:
+		bool ScanLine(StringView line, StringView* fields) const
+		{
+			size_t pos = 0;
+			size_t field = 0;
+			for (const auto& curr : m_tokens)
+			{
+				StringView res;
+				if (detail::FindField(line, curr, pos, res) != ExtractError::None)
+					return false;
 
-		template<typename T, typename... Args>
-		void AddData(std::vector<DataTypeRef>& results, T& value, Args & ... args)
+				if (curr.type != TokenType::None)
+					fields[field++] = res;
+			}
+			return true;
+		}
+
+		static void Reserve(Column& column, size_t rows)
 		{
-			results.push_back({ value });
-			AddData(results, args...);
+			column.validity.resize((rows + 7) / 8, 0);
 		}
 
-		inline void ValuesExtractHelp(const std::string& input, const std::vector<Token>& tokens, std::vector<DataTypeRef>& results)
+		static void SetValid(Column& column, size_t row)
 		{
-			size_t token_size = 0;
+			column.validity[row >> 3] |= static_cast<uint8_t>(1u << (row & 7));
+		}
 
-			for (size_t i = 0; i < tokens.size(); ++i)
+		template<typename T>
+		void ConvertColumn(Column& column, size_t field, size_t count, std::vector<T>& values)
+		{
+			const Token& token = m_tokens[m_fieldTokens[field]];
+			const size_t fieldCount = m_columns.size();
+			size_t row = column.rows;
+			values.resize(row + count);
+			for (size_t i = 0; i < count; ++i, ++row)
 			{
-				if (tokens[i].type != TokenType::None)
-					++token_size;
+				T value = 0;
+				if (m_matched[i] && detail::ConvertField(m_fields[i * fieldCount + field], token.type, token.layout, value) == ExtractError::None)
+				{
+					values[row] = value;
+					SetValid(column, row);
+				}
+				else
+					values[row] = 0;
 			}
+			column.rows = row;
+		}
 
-			if (results.size() != token_size)
+		void ConvertStrings(Column& column, size_t field, size_t count)
+		{
+			const size_t fieldCount = m_columns.size();
+			size_t row = column.rows;
+			for (size_t i = 0; i < count; ++i, ++row)
 			{
-				std::cerr << "Number of parameters and fmt token mismatched\n";
-				return;
+				if (m_matched[i])
+				{
+					StringView str = m_fields[i * fieldCount + field];
+					column.bytes.append(str.data, str.size);
+					SetValid(column, row);
+				}
+				column.offsets.push_back(static_cast<uint64_t>(column.bytes.size()));
 			}
+			column.rows = row;
+		}
 
-			size_t prefix_pos = 0;
-			size_t postfix_pos = 0;
-			for (size_t i = 0; i < tokens.size(); ++i)
-			{
-				auto& curr = tokens[i];
+		std::vector<Token> m_tokens;
+		// index in m_tokens of the field of each column
+		std::vector<size_t> m_fieldTokens;
+		std::vector<Column> m_columns;
+		// scratch of a batch: the fields of row i start at i * columns
+		std::vector<StringView> m_fields;
+		std::vector<uint8_t> m_matched;
+		std::vector<StringView> m_lines;
+	};
 
-				if (curr.prefix.empty() == false)
-				{
-					prefix_pos = input.find(curr.prefix, prefix_pos);
+#ifdef VALUES_HAS_CONSTEXPR14
+	namespace detail
+	{
+		struct CtToken
+		{
+			TokenType type;
+			int index;
+			size_t prefixPos;
+			size_t prefixLen;
+			size_t postfixPos;
+			size_t postfixLen;
+			Searcher prefixSearcher;
+			Searcher postfixSearcher;
+			Anchor prefixAnchor;
+			Anchor postfixAnchor;
+			size_t width;
+			// the characters to trim or the layout, in the fmt
+			size_t argPos;
+			size_t argLen;
+		};
 
-					if (prefix_pos == std::string::npos)
-					{
-						std::cerr << "prefix_pos Error\n";
-						return;
-					}
-					prefix_pos += curr.prefix.size();
-				}
+		template<size_t N>
+		struct CtTokens
+		{
+			CtToken tokens[N > 0 ? N : 1];
+			size_t count;
+			bool sideBySide;
+			bool misplacedAnchor;
+		};
 
-				postfix_pos = prefix_pos + 1;
-				if (curr.postfix.empty() == false)
+		// Compile-time twin of TokenizeFmtString. Prefix and postfix are kept
+		// as offsets into the format literal. With N == 0, only the number of
+		// tokens is counted.
+		template<size_t N>
+		constexpr CtTokens<N> CtTokenize(const char* fmt)
+		{
+			CtTokens<N> res{};
+
+			size_t len = 0;
+			while (fmt[len] != '\0')
+				++len;
+
+			int index = 0;
+			size_t literal_start = 0;
+			size_t literal_end = len;
+			Anchor anchor;
+			bool prev_bounded = false; // its end is known without the postfix
+			size_t pos = 0;
+			while (pos < len)
+			{
+				if (fmt[pos] != '{')
 				{
-					postfix_pos = input.find(curr.postfix, postfix_pos);
+					++pos;
+					continue;
+				}
 
-					if (postfix_pos == std::string::npos)
+				size_t close = pos + 1;
+				while (close < len && fmt[close] != '}')
+					++close;
+				if (close == len)
+					break;
+
+				Anchor marker;
+				if (ParseAnchor(fmt + pos + 1, close - pos - 1, marker))
+				{
+					const bool atEnd = (marker.kind == AnchorKind::End);
+					const bool atStart = (fmt[pos + 1] == '^');
+					if (anchor.kind != AnchorKind::None || (atEnd ? close + 1 != len : literal_start != pos) || (atStart && pos != 0))
+						res.misplacedAnchor = true;
+					anchor = marker;
+					if (atEnd)
 					{
-						postfix_pos = prefix_pos;
-						if (curr.postfix.empty() == false)
-						{
-							postfix_pos = input.find(curr.postfix, postfix_pos);
-						}
-						if (postfix_pos == std::string::npos)
-						{
-							std::cerr << "postfix_pos Error\n";
-							return;
-						}
+						literal_end = pos;
+						break;
 					}
+					literal_start = close + 1;
+					pos = close + 1;
+					continue;
 				}
-				else
+
+				size_t width = 0;
+				size_t argPos = 0;
+				size_t argLen = 0;
+				const size_t digits = ParseWidth(fmt + pos + 1, close - pos - 1, width);
+				const int spec = (digits == 0 || width != 0) ?
+					ParseSpecifier(fmt + pos + 1 + digits, close - pos - 1 - digits, argPos, argLen) : -1;
+				if (spec < 0)
 				{
-					postfix_pos = std::string::npos;
+					++pos;
+					continue;
 				}
 
-				std::string res;
-				if (prefix_pos != std::string::npos)
+				if (res.count > 0)
 				{
-					if (postfix_pos == std::string::npos)
-						res = input.substr(prefix_pos);
-					else
-						res = input.substr(prefix_pos, postfix_pos - prefix_pos);
-					if (curr.index != -1)
+					if (literal_start == pos && anchor.kind == AnchorKind::None && prev_bounded == false)
+						res.sideBySide = true;
+					if (res.count <= N)
 					{
-						results.at(curr.index).ConvStrToType(res, curr.type);
+						res.tokens[res.count - 1].postfixPos = literal_start;
+						res.tokens[res.count - 1].postfixLen = pos - literal_start;
+						res.tokens[res.count - 1].postfixAnchor = anchor;
 					}
 				}
-				prefix_pos += res.size();
+				if (res.count < N)
+				{
+					CtToken& curr = res.tokens[res.count];
+					curr.type = SpecifierTable<>::entries[spec].type;
+					curr.index = (curr.type != TokenType::None) ? index : -1;
+					curr.prefixPos = literal_start;
+					curr.prefixLen = pos - literal_start;
+					curr.prefixAnchor = anchor;
+					curr.width = width;
+					curr.argPos = pos + 1 + digits + argPos;
+					curr.argLen = argLen;
+				}
+				const TokenType type = SpecifierTable<>::entries[spec].type;
+				prev_bounded = width != 0 || type == TokenType::Digits || type == TokenType::Word || type == TokenType::Alnum ||
+					type == TokenType::Timestamp || type == TokenType::Ipv4 || type == TokenType::Ipv6 || type == TokenType::Mac;
+				if (SpecifierTable<>::entries[spec].type != TokenType::None)
+					++index;
+				++res.count;
+
+				anchor = Anchor();
+				literal_start = close + 1;
+				pos = close + 1;
+			}
+
+			if (res.count > 0 && res.count <= N)
+			{
+				res.tokens[res.count - 1].postfixPos = literal_start;
+				res.tokens[res.count - 1].postfixLen = literal_end - literal_start;
+				res.tokens[res.count - 1].postfixAnchor = anchor;
+			}
+			for (size_t i = 0; i < res.count && i < N; ++i)
+			{
+				CtToken& curr = res.tokens[i];
+				curr.prefixSearcher = MakeSearcher(fmt + curr.prefixPos, curr.prefixLen);
+				curr.postfixSearcher = MakeSearcher(fmt + curr.postfixPos, curr.postfixLen);
 			}
+			return res;
 		}
-	}
 
-	template<typename... Args>
-	void ValuesExtract(const std::string& input, const char* fmt, Args & ... args)
-	{
-		std::vector<Token> tokens = TokenizeFmtString(fmt);
+		template<size_t N>
+		constexpr size_t CtArgCount(const CtTokens<N>& tokens)
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < tokens.count; ++i)
+			{
+				if (tokens.tokens[i].type != TokenType::None)
+					++count;
+			}
+			return count;
+		}
 
-		std::vector<DataTypeRef> results;
+		struct CtFormatTag {};
 
-		detail::AddData(results, args...);
+		// Tokens of the format literal returned by Fmt::Get(), computed once
+		// at compile time.
+		template<typename Fmt>
+		struct CtFormat
+		{
+			static constexpr size_t count = CtTokenize<0>(Fmt::Get()).count;
+			static constexpr CtTokens<count> tokens = CtTokenize<count>(Fmt::Get());
+			static constexpr size_t argCount = CtArgCount(tokens);
+		};
 
-		detail::ValuesExtractHelp(input, tokens, results);
-	}
+		template<typename Fmt>
+		constexpr size_t CtFormat<Fmt>::count;
 
-	template<typename... Args>
-	void ValuesExtract(const std::string& input, const std::vector<Token>& tokens, Args & ... args)
-	{
-		std::vector<DataTypeRef> results;
+		template<typename Fmt>
+		constexpr CtTokens<CtFormat<Fmt>::count> CtFormat<Fmt>::tokens;
 
-		detail::AddData(results, args...);
+		template<typename Fmt>
+		constexpr size_t CtFormat<Fmt>::argCount;
 
-		detail::ValuesExtractHelp(input, tokens, results);
-	}
+		template<typename T> struct IsIntegerArg : std::false_type {};
+		template<> struct IsIntegerArg<int16_t> : std::true_type {};
+		template<> struct IsIntegerArg<uint16_t> : std::true_type {};
+		template<> struct IsIntegerArg<int32_t> : std::true_type {};
+		template<> struct IsIntegerArg<uint32_t> : std::true_type {};
+		template<> struct IsIntegerArg<int64_t> : std::true_type {};
+		template<> struct IsIntegerArg<uint64_t> : std::true_type {};
 
-	bool IsInputMatchedFmt(const std::string& input, const char* fmt)
-	{
-		std::vector<Token> tokens = TokenizeFmtString(fmt);
+		template<typename T> struct IsTimePointArg : std::false_type {};
+		template<typename Duration> struct IsTimePointArg<std::chrono::time_point<std::chrono::system_clock, Duration> > : std::true_type {};
 
-		size_t pos = 0;
-		size_t prev_pos = 0;
-		for (const auto& token : tokens)
+		// Converts a field into the argument at Index. The specifier type is
+		// known at compile time, so the argument type of {h}, {ip}, {ip6},
+		// {mac} and {ts} is checked by the compiler; the other specifiers
+		// take any type which ConvertTo takes.
+		template<int Index, TokenType Type>
+		struct CtArg
 		{
-			if (token.prefix.empty() == false)
+			template<typename Tuple>
+			static void Convert(StringView field, StringView layout, Tuple& args)
 			{
-				pos = input.find(token.prefix, prev_pos);
+				typedef typename std::remove_reference<typename std::tuple_element<Index, Tuple>::type>::type Arg;
+				static_assert(Type != TokenType::Hex || IsIntegerArg<Arg>::value, "{h} must be extracted into an integer");
+				static_assert(Type != TokenType::Ipv4 || std::is_same<Arg, uint32_t>::value || std::is_same<Arg, int64_t>::value || std::is_same<Arg, uint64_t>::value,
+					"{ip} must be extracted into a uint32_t, int64_t or uint64_t");
+				static_assert(Type != TokenType::Ipv6 || std::is_same<Arg, std::array<uint8_t, 16> >::value, "{ip6} must be extracted into a std::array<uint8_t, 16>");
+				static_assert(Type != TokenType::Mac || std::is_same<Arg, std::array<uint8_t, 6> >::value, "{mac} must be extracted into a std::array<uint8_t, 6>");
+				static_assert(Type != TokenType::Timestamp || std::is_same<Arg, int64_t>::value || IsTimePointArg<Arg>::value,
+					"{ts} must be extracted into an int64_t or a std::chrono::system_clock time_point");
 
-				if (pos != std::string::npos)
-				{
-					if (pos < prev_pos)
-						return false;
-				}
-				else
-					return false;
-
-				prev_pos = pos;
+				ThrowIfEmpty(ConvertField(field, Type, layout, std::get<Index>(args)));
 			}
+		};
 
-			if (token.postfix.empty() == false)
+		template<TokenType Type>
+		struct CtArg<-1, Type>
+		{
+			template<typename Tuple>
+			static void Convert(StringView, StringView, Tuple&)
 			{
-				pos = input.find(token.postfix, prev_pos);
+			}
+		};
 
-				if (pos != std::string::npos)
-				{
-					if (pos < prev_pos)
-						return false;
-				}
-				else
-					return false;
+		template<typename Fmt, size_t I, typename Tuple>
+		bool CtExtractToken(StringView input, size_t& pos, Tuple& args)
+		{
+			constexpr CtToken curr = CtFormat<Fmt>::tokens.tokens[I];
 
-				prev_pos = pos;
-			}
+			const Delimiter prefix = { StringView(Fmt::Get() + curr.prefixPos, curr.prefixLen), curr.prefixSearcher, curr.prefixAnchor };
+			const Delimiter postfix = { StringView(Fmt::Get() + curr.postfixPos, curr.postfixLen), curr.postfixSearcher, curr.postfixAnchor };
+			StringView field;
+			const StringView arg(Fmt::Get() + curr.argPos, curr.argLen);
+			ExtractError error = FindField(input, prefix, postfix, curr.width, curr.type, arg, pos, field);
+			if (error != ExtractError::None)
+				return false;
+
+			field = TrimField(field, curr.type, arg);
+			CtArg<curr.index, curr.type>::Convert(field, arg, args);
+			return true;
 		}
-		return true;
-	}
-	bool IsInputMatchedTokens(const std::string& input, const std::vector<Token>& tokens)
-	{
-		size_t pos = 0;
-		size_t prev_pos = 0;
-		for (const auto& token : tokens)
-		{
-			if (token.prefix.empty() == false)
-			{
-				pos = input.find(token.prefix, prev_pos);
 
-				if (pos != std::string::npos)
-				{
-					if (pos < prev_pos)
-						return false;
-				}
-				else
-					return false;
+		template<typename Fmt, typename Tuple, size_t... I>
+		bool CtValuesExtract(StringView input, Tuple& args, std::index_sequence<I...>)
+		{
+			size_t pos = 0;
+			bool matched = true;
+			bool unused[] = { true, (matched = matched && CtExtractToken<Fmt, I>(input, pos, args))... };
+			(void)unused;
+			return matched;
+		}
+	}
 
-				prev_pos = pos;
-			}
+	// Format literal which is tokenized at compile time, for example
+	// ValuesExtract(input, VALUES_FMT("REGISTER Name:{}, Age:{}"), name, age);
+	#define VALUES_FMT(fmt) \
+		[] { struct ValuesFmt : ::values::detail::CtFormatTag { static constexpr const char* Get() { return fmt; } }; return ValuesFmt(); }()
 
-			if (token.postfix.empty() == false)
-			{
-				pos = input.find(token.postfix, prev_pos);
+	// Extracts with a compile-time format: the number of arguments and their
+	// types are checked by the compiler and the matcher is unrolled with the
+	// literal delimiters. Returns false if a delimiter is not found.
+	template<typename Fmt, typename... Args>
+	typename std::enable_if<std::is_base_of<detail::CtFormatTag, Fmt>::value, bool>::type
+		ValuesExtract(StringView input, Fmt, Args & ... args)
+	{
+		typedef detail::CtFormat<Fmt> Format;
+		static_assert(Format::tokens.sideBySide == false, "Format specifier {} cannot be side by side! For example: {}{}");
+		static_assert(Format::tokens.misplacedAnchor == false, "Anchor {^} must start the fmt, {@N} a literal and {$} must end the fmt!");
+		static_assert(Format::argCount == sizeof...(Args), "Number of parameters and fmt token mismatched");
 
-				if (pos != std::string::npos)
-				{
-					if (pos < prev_pos)
-						return false;
-				}
-				else
-					return false;
+		std::tuple<Args&...> refs(args...);
+		return detail::CtValuesExtract<Fmt>(input, refs, std::make_index_sequence<Format::count>());
+	}
 
-				prev_pos = pos;
-			}
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+	template<size_t N>
+	struct FixedString
+	{
+		constexpr FixedString(const char (&str)[N])
+		{
+			for (size_t i = 0; i < N; ++i)
+				data[i] = str[i];
 		}
-		return true;
+
+		char data[N] = {};
+	};
+
+	namespace detail
+	{
+		template<FixedString Str>
+		struct CtFixedFormat : CtFormatTag
+		{
+			static constexpr const char* Get() { return Str.data; }
+		};
 	}
 
+	// C++20 form of the compile-time format:
+	// ValuesExtract<"REGISTER Name:{}, Age:{}">(input, name, age);
+	template<FixedString Fmt, typename... Args>
+	bool ValuesExtract(StringView input, Args & ... args)
+	{
+		return ValuesExtract(input, detail::CtFixedFormat<Fmt>(), args...);
+	}
+#endif
+#endif
 }
\ No newline at end of file
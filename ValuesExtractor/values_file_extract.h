@@ -0,0 +1,507 @@
+// The MIT License (MIT)
+// C++ Values Extractor aka scanf 0.1.1
+// Copyright (C) 2025, by Wong Shao Voon (shaovoon@yahoo.com)
+//
+// http://opensource.org/licenses/MIT
+
+#pragma once
+#include "values_extract.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <exception>
+#include <cerrno>
+
+#if defined(_WIN32)
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+	#include <io.h>
+#elif defined(__unix__) || defined(__APPLE__)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#define VALUES_HAS_MMAP 1
+#endif
+
+namespace values
+{
+	// Read-only view of a whole file: memory-mapped where the platform
+	// allows it, else read into memory.
+	class MappedFile
+	{
+	public:
+		MappedFile()
+			: m_data(nullptr)
+			, m_size(0)
+#if defined(_WIN32)
+			, m_file(INVALID_HANDLE_VALUE)
+			, m_mapping(nullptr)
+#endif
+		{
+		}
+
+		~MappedFile()
+		{
+			Close();
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const char* path)
+		{
+			Close();
+#if defined(_WIN32)
+			m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (m_file == INVALID_HANDLE_VALUE)
+				return false;
+			LARGE_INTEGER size;
+			if (GetFileSizeEx(m_file, &size) == FALSE)
+			{
+				Close();
+				return false;
+			}
+			m_size = static_cast<size_t>(size.QuadPart);
+			if (m_size == 0)
+				return true;
+			m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (m_mapping == nullptr)
+			{
+				Close();
+				return false;
+			}
+			m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+			if (m_data == nullptr)
+			{
+				Close();
+				return false;
+			}
+			return true;
+#elif defined(VALUES_HAS_MMAP)
+			int fd = open(path, O_RDONLY);
+			if (fd < 0)
+				return false;
+			struct stat st;
+			if (fstat(fd, &st) != 0)
+			{
+				close(fd);
+				return false;
+			}
+			m_size = static_cast<size_t>(st.st_size);
+			if (m_size > 0)
+			{
+				void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (data == MAP_FAILED)
+				{
+					close(fd);
+					m_size = 0;
+					return false;
+				}
+				madvise(data, m_size, MADV_SEQUENTIAL);
+				m_data = static_cast<const char*>(data);
+			}
+			close(fd);
+			return true;
+#else
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				return false;
+			m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			m_data = m_buffer.data();
+			m_size = m_buffer.size();
+			return true;
+#endif
+		}
+
+		void Close()
+		{
+#if defined(_WIN32)
+			if (m_data)
+				UnmapViewOfFile(m_data);
+			if (m_mapping)
+				CloseHandle(m_mapping);
+			if (m_file != INVALID_HANDLE_VALUE)
+				CloseHandle(m_file);
+			m_mapping = nullptr;
+			m_file = INVALID_HANDLE_VALUE;
+#elif defined(VALUES_HAS_MMAP)
+			if (m_data)
+				munmap(const_cast<char*>(m_data), m_size);
+#else
+			m_buffer.clear();
+#endif
+			m_data = nullptr;
+			m_size = 0;
+		}
+
+		StringView View() const
+		{
+			return m_data ? StringView(m_data, m_size) : StringView();
+		}
+
+	private:
+		const char* m_data;
+		size_t m_size;
+#if defined(_WIN32)
+		HANDLE m_file;
+		HANDLE m_mapping;
+#elif !defined(VALUES_HAS_MMAP)
+		std::string m_buffer;
+#endif
+	};
+
+	// Splits the buffer into at most count chunks of about the same size,
+	// each one ending after a '\n' (or at the end of the buffer).
+	inline std::vector<StringView> SplitChunks(StringView buffer, size_t count)
+	{
+		std::vector<StringView> chunks;
+		if (count == 0)
+			count = 1;
+
+		size_t begin = 0;
+		for (size_t i = 1; i <= count && begin < buffer.size; ++i)
+		{
+			size_t end = buffer.size;
+			if (i < count)
+			{
+				size_t target = std::max(begin, buffer.size / count * i);
+				const void* newline = memchr(buffer.data + target, '\n', buffer.size - target);
+				if (newline)
+					end = static_cast<const char*>(newline) - buffer.data + 1;
+			}
+			chunks.push_back(buffer.substr(begin, end - begin));
+			begin = end;
+		}
+		return chunks;
+	}
+
+	// Calls onLine for each line of the chunk, without its "\n" or "\r\n"
+	template<typename F>
+	size_t ForEachLine(StringView chunk, F onLine)
+	{
+		size_t lines = 0;
+		const char* curr = chunk.begin();
+		const char* last = chunk.end();
+		while (curr < last)
+		{
+			const char* newline = static_cast<const char*>(memchr(curr, '\n', last - curr));
+			const char* end = newline ? newline : last;
+			onLine(detail::MakeLine(curr, end));
+			++lines;
+			curr = end + 1;
+		}
+		return lines;
+	}
+
+	enum class MergeOrder
+	{
+		// rows in the order of the lines in the file
+		Ordered,
+		// rows in the order the workers are done with them
+		Unordered
+	};
+
+	struct FileExtractStats
+	{
+		size_t bytes;
+		size_t lines;
+		size_t matched;
+		double seconds;
+
+		double MBPerSecond() const
+		{
+			return (seconds > 0.0) ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+		}
+		double LinesPerSecond() const
+		{
+			return (seconds > 0.0) ? lines / seconds : 0.0;
+		}
+	};
+
+	// Extracts the lines of a large buffer (like a MappedFile) on a pool of
+	// worker threads. The buffer is split into newline-aligned chunks,
+	// several per thread so that a slow chunk does not hold up the others,
+	// and the workers take the next chunk until there is none left.
+	class FileExtractor
+	{
+	public:
+		explicit FileExtractor(const std::vector<Token>& tokens, size_t threads = 0)
+			: m_tokens(tokens)
+			, m_threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+		{
+		}
+
+		// extractRow(StringView line, const std::vector<Token>& tokens, Row& row)
+		// returns true when the line matches, for instance
+		// return (bool)ValuesExtractChecked(line, tokens, row.name, row.age);
+		// The rows are appended to rows. If extractRow throws, Run rethrows
+		// the exception after the workers have stopped, and rows is unchanged.
+		template<typename Row, typename F>
+		FileExtractStats Run(StringView buffer, F extractRow, std::vector<Row>& rows, MergeOrder order = MergeOrder::Ordered) const
+		{
+			auto begin = std::chrono::steady_clock::now();
+
+			std::vector<StringView> chunks = SplitChunks(buffer, m_threads * ChunksPerThread);
+			// Ordered: the rows of chunk i; Unordered: the rows of worker i
+			std::vector<std::vector<Row> > results((order == MergeOrder::Ordered) ? chunks.size() : m_threads);
+			std::vector<size_t> lineCounts(m_threads, 0);
+			std::atomic<size_t> nextChunk(0);
+
+			// an exception of extractRow is kept by its worker, which stops
+			// the others, and rethrown by Run once they are joined
+			std::vector<std::exception_ptr> errors(m_threads);
+
+			auto worker = [&](size_t id)
+			{
+				size_t lines = 0;
+				try
+				{
+					for (size_t chunk = nextChunk++; chunk < chunks.size(); chunk = nextChunk++)
+					{
+						std::vector<Row>& out = results[(order == MergeOrder::Ordered) ? chunk : id];
+						lines += ForEachLine(chunks[chunk], [&](StringView line)
+						{
+							Row row = Row();
+							if (extractRow(line, m_tokens, row))
+								out.push_back(std::move(row));
+						});
+					}
+				}
+				catch (...)
+				{
+					errors[id] = std::current_exception();
+					nextChunk = chunks.size();
+				}
+				lineCounts[id] = lines;
+			};
+
+			std::vector<std::thread> pool;
+			for (size_t id = 1; id < m_threads; ++id)
+				pool.push_back(std::thread(worker, id));
+			worker(0);
+			for (auto& thread : pool)
+				thread.join();
+			for (auto& error : errors)
+			{
+				if (error)
+					std::rethrow_exception(error);
+			}
+
+			FileExtractStats stats = { buffer.size, 0, 0, 0.0 };
+			for (size_t lines : lineCounts)
+				stats.lines += lines;
+			for (auto& result : results)
+			{
+				stats.matched += result.size();
+				rows.insert(rows.end(), std::make_move_iterator(result.begin()), std::make_move_iterator(result.end()));
+			}
+			stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+			return stats;
+		}
+
+		size_t Threads() const
+		{
+			return m_threads;
+		}
+
+	private:
+		static const size_t ChunksPerThread = 8;
+
+		std::vector<Token> m_tokens;
+		size_t m_threads;
+	};
+
+	// Splits a byte stream into lines, reading it a block at a time. The
+	// lines are handed out as views into the buffer, which holds the block
+	// being read and the start of the line it cuts, so the memory is bounded
+	// by the block size plus the longest line. Only the cut line is moved to
+	// the front of the buffer before the next block is read.
+	class LineReader
+	{
+	public:
+		static const size_t DefaultBlockSize = 64 * 1024;
+
+		explicit LineReader(size_t blockSize = DefaultBlockSize)
+			: m_blockSize(blockSize ? blockSize : DefaultBlockSize)
+			, m_error(0)
+		{
+		}
+
+		// read(char* dest, size_t size) returns the number of bytes read,
+		// 0 at the end of the stream or on an error, which it records with
+		// SetError. onLine(StringView line) is called for each line; the
+		// view is valid until onLine returns.
+		template<typename Source, typename F>
+		size_t ReadFrom(Source read, F onLine)
+		{
+			size_t lines = 0;
+			size_t pending = 0;
+			m_error = 0;
+			while (true)
+			{
+				if (m_buffer.size() < pending + m_blockSize)
+					m_buffer.resize(pending + m_blockSize);
+
+				size_t count = read(m_buffer.data() + pending, m_blockSize);
+				if (count == 0)
+					break;
+
+				char* data = m_buffer.data();
+				const char* begin = data;
+				// the pending bytes have no '\n'
+				const char* curr = data + pending;
+				const char* last = curr + count;
+				const char* newline;
+				while ((newline = static_cast<const char*>(memchr(curr, '\n', last - curr))) != nullptr)
+				{
+					onLine(detail::MakeLine(begin, newline));
+					++lines;
+					begin = curr = newline + 1;
+				}
+				pending = last - begin;
+				if (begin != data && pending > 0)
+					memmove(data, begin, pending);
+			}
+			// the line cut by a failed read is not complete
+			if (pending > 0 && m_error == 0)
+			{
+				onLine(detail::MakeLine(m_buffer.data(), m_buffer.data() + pending));
+				++lines;
+			}
+			return lines;
+		}
+
+		// Reads a stream until its end. A stream which goes bad stops it
+		// like a read error of a file descriptor, with EIO.
+		template<typename F>
+		size_t Read(std::istream& in, F onLine)
+		{
+			return ReadFrom([this, &in](char* dest, size_t size)
+			{
+				in.read(dest, static_cast<std::streamsize>(size));
+				if (in.bad())
+					SetError(EIO);
+				return static_cast<size_t>(in.gcount());
+			}, onLine);
+		}
+
+		// Reads a file descriptor, like a pipe, until its end. A read error
+		// other than EINTR stops it; Failed() then tells it from the end.
+		template<typename F>
+		size_t Read(int fd, F onLine)
+		{
+			return ReadFrom([this, fd](char* dest, size_t size) -> size_t
+			{
+				while (true)
+				{
+#if defined(_WIN32)
+					int count = _read(fd, dest, static_cast<unsigned int>(size));
+#else
+					ssize_t count = read(fd, dest, size);
+#endif
+					if (count >= 0)
+						return static_cast<size_t>(count);
+					if (errno != EINTR)
+					{
+						SetError(errno);
+						return 0;
+					}
+				}
+			}, onLine);
+		}
+
+		// Bytes held by the buffer
+		size_t Capacity() const
+		{
+			return m_buffer.size();
+		}
+
+		// Whether the last Read stopped on a read error rather than at the end
+		bool Failed() const
+		{
+			return m_error != 0;
+		}
+
+		// errno of the failed read (EIO for a stream), 0 if the last Read
+		// did not fail
+		int Error() const
+		{
+			return m_error;
+		}
+
+		void SetError(int error)
+		{
+			m_error = error;
+		}
+
+	private:
+		size_t m_blockSize;
+		std::vector<char> m_buffer;
+		int m_error;
+	};
+
+	// Extracts the lines of a stream which match the format into the
+	// parameters and calls onMatch(line) after each one. A StringView
+	// parameter points into the buffer of the reader and is valid until
+	// onMatch returns.
+	class StreamExtractor
+	{
+	public:
+		explicit StreamExtractor(const std::vector<Token>& tokens, size_t blockSize = LineReader::DefaultBlockSize)
+			: m_tokens(tokens)
+			, m_reader(blockSize)
+			, m_lines(0)
+		{
+		}
+
+		// Returns the number of lines matched
+		template<typename F, typename... Args>
+		size_t Read(std::istream& in, F onMatch, Args & ... args)
+		{
+			return ReadImpl(in, onMatch, args...);
+		}
+
+		template<typename F, typename... Args>
+		size_t Read(int fd, F onMatch, Args & ... args)
+		{
+			return ReadImpl(fd, onMatch, args...);
+		}
+
+		// Lines read by the last Read
+		size_t Lines() const
+		{
+			return m_lines;
+		}
+
+		const LineReader& Reader() const
+		{
+			return m_reader;
+		}
+
+	private:
+		template<typename Source, typename F, typename... Args>
+		size_t ReadImpl(Source& source, F& onMatch, Args & ... args)
+		{
+			size_t matched = 0;
+			m_lines = m_reader.Read(source, [&](StringView line)
+			{
+				if (ValuesExtractChecked(line, m_tokens, args...))
+				{
+					++matched;
+					onMatch(line);
+				}
+			});
+			return matched;
+		}
+
+		std::vector<Token> m_tokens;
+		LineReader m_reader;
+		size_t m_lines;
+	};
+}